@@ -0,0 +1,80 @@
+#include "batch.h"
+#include "../common/parallel.h"
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+using namespace std;
+
+RouteQuery::RouteQuery() : type(1), s(0), t(0) {}
+RouteQuery::RouteQuery(int ty, int a, int b) : type(ty), s(a), t(b) {}
+
+RouteAnswer::RouteAnswer() : valid(false), ok(false), dist(0), elapsedMs(0) {}
+
+// 分组排序键：模式在前、起点在后，原始下标保证稳定
+struct GroupKey {
+    int mode;
+    int s;
+    int index;
+};
+
+static bool groupKeyLess(const GroupKey& a, const GroupKey& b) {
+    if (a.mode != b.mode) return a.mode < b.mode;
+    if (a.s != b.s) return a.s < b.s;
+    return a.index < b.index;
+}
+
+void runBatchQueries(const CsrGraph& g, const PrecomputedCost costOf[2], const vector<RouteQuery>& queries, int threads, vector<RouteAnswer>& answers) {
+    int q = (int)queries.size();
+    answers.assign(q, RouteAnswer());
+
+    // 只保留节点编号有效的查询参与分组
+    vector<GroupKey> keys;
+    keys.reserve(q);
+    for (int i = 0; i < q; ++i) {
+        const RouteQuery& rq = queries[i];
+        if (rq.s < 1 || rq.s > g.n || rq.t < 1 || rq.t > g.n) continue;
+        answers[i].valid = true;
+        GroupKey k;
+        k.mode = (rq.type == 2 ? 1 : 0);
+        k.s = rq.s;
+        k.index = i;
+        keys.push_back(k);
+    }
+    sort(keys.begin(), keys.end(), groupKeyLess);
+
+    // groupBegin[k]..groupBegin[k+1] 为第 k 组在 keys 中的范围
+    vector<int> groupBegin;
+    for (int i = 0; i < (int)keys.size(); ++i) {
+        if (i == 0 || keys[i].mode != keys[i - 1].mode || keys[i].s != keys[i - 1].s) groupBegin.push_back(i);
+    }
+    int groups = (int)groupBegin.size();
+    groupBegin.push_back((int)keys.size());
+
+    if (threads < 1) threads = 1;
+    vector<DijkstraWorkspace> ws(threads);
+    vector< vector<int> > targets(threads);
+
+    parallelFor(groups, threads, [&](int gi, int tid) {
+        int b = groupBegin[gi], e = groupBegin[gi + 1];
+        int mode = keys[b].mode;
+        int s = keys[b].s;
+        vector<int>& tg = targets[tid];
+        tg.clear();
+        for (int k = b; k < e; ++k) tg.push_back(queries[keys[k].index].t);
+
+        chrono::steady_clock::time_point st = chrono::steady_clock::now();
+        dijkstraToTargets(g, costOf[mode], s, tg, ws[tid]);
+        chrono::steady_clock::time_point ed = chrono::steady_clock::now();
+        double ms = chrono::duration<double, milli>(ed - st).count();
+
+        for (int k = b; k < e; ++k) {
+            int t = queries[keys[k].index].t;
+            RouteAnswer& ans = answers[keys[k].index];
+            ans.elapsedMs = ms;
+            ans.dist = ws[tid].distOf(t);
+            ans.ok = ans.dist != numeric_limits<double>::infinity();
+            if (ans.ok) ans.path = buildPath(ws[tid], s, t);
+        }
+    });
+}
@@ -0,0 +1,33 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+// 批量查询模块
+// 先读入全部查询，按（起点, 模式）分组；每组只做一次单源搜索，组内所有终点都确定后即停止
+// 各组分配到线程池并行执行（图只读共享，每个线程持有自己的工作区），结果按原始查询顺序保存
+
+#include <vector>
+#include "graph.h"
+
+// 一条查询：type=1 按长度，type=2 按加权通行时间
+struct RouteQuery {
+    int type;
+    int s;
+    int t;
+    RouteQuery();
+    RouteQuery(int ty, int a, int b);
+};
+
+// 一条查询的结果
+struct RouteAnswer {
+    bool valid;    // valid：节点编号是否有效
+    bool ok;    // ok：是否可达
+    double dist;    // dist：最短代价
+    std::vector<int> path;    // path：节点序列
+    double elapsedMs;    // elapsedMs：所在分组单源搜索的耗时（毫秒）
+    RouteAnswer();
+};
+
+// 批量执行：costOf[0]/costOf[1] 为两种模式的预计算边权，threads 为线程数
+void runBatchQueries(const CsrGraph& g, const PrecomputedCost costOf[2], const std::vector<RouteQuery>& queries, int threads, std::vector<RouteAnswer>& answers);
+
+#endif
@@ -0,0 +1,441 @@
+#include "ch.h"
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+ContractionHierarchy::ContractionHierarchy() : n(0), m(0), lightWait(0), reordered(false), weightChecksum(0) {}
+
+static const double INF = numeric_limits<double>::infinity();
+static const int WITNESS_SETTLE_LIMIT = 100;    // 见证搜索最多确定的节点数，超出则保守地添加捷径
+
+// 收缩过程中的弧：to 为邻居，w 为代价，mid 为捷径中间节点（原始边为 -1）
+struct ChArc {
+    int to;
+    double w;
+    int mid;
+    ChArc() : to(0), w(0), mid(-1) {}
+    ChArc(int t, double ww, int m) : to(t), w(ww), mid(m) {}
+};
+
+// 收缩用的临时状态
+struct ChBuilder {
+    int n;
+    vector< vector<ChArc> > adj;    // 仅保存未收缩节点之间的弧（对称存放）
+    vector<char> contracted;
+    vector<int> deletedNeighbors;
+    // 见证搜索工作区
+    vector<double> wdist;
+    vector<int> wtouched;
+    vector<NodeDist> wheap;
+};
+
+// 插入或更新 u-v 弧，保留较小代价
+static void addOrUpdateArc(vector<ChArc>& arcs, int to, double w, int mid) {
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (arcs[i].to == to) {
+            if (w < arcs[i].w) {
+                arcs[i].w = w;
+                arcs[i].mid = mid;
+            }
+            return;
+        }
+    }
+    arcs.push_back(ChArc(to, w, mid));
+}
+
+// 见证搜索：从 src 出发、绕开 avoid 与已收缩节点，代价上限 maxW
+static void witnessSearch(ChBuilder& b, int src, int avoid, double maxW) {
+    for (size_t i = 0; i < b.wtouched.size(); ++i) b.wdist[b.wtouched[i]] = INF;
+    b.wtouched.clear();
+
+    vector<NodeDist>& heap = b.wheap;
+    NodeDistGreater cmp;
+    heap.clear();
+    b.wdist[src] = 0.0;
+    b.wtouched.push_back(src);
+    heap.push_back(NodeDist(src, 0.0));
+    int settled = 0;
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), cmp);
+        NodeDist cur = heap.back();
+        heap.pop_back();
+        int u = cur.node;
+        if (cur.dist != b.wdist[u]) continue;
+        if (cur.dist > maxW) break;
+        if (++settled > WITNESS_SETTLE_LIMIT) break;
+        const vector<ChArc>& arcs = b.adj[u];
+        for (size_t i = 0; i < arcs.size(); ++i) {
+            int v = arcs[i].to;
+            if (v == avoid) continue;
+            double nd = cur.dist + arcs[i].w;
+            if (nd < b.wdist[v]) {
+                if (b.wdist[v] == INF) b.wtouched.push_back(v);
+                b.wdist[v] = nd;
+                heap.push_back(NodeDist(v, nd));
+                push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+}
+
+// 收缩节点 v（或仅模拟）：返回需要添加的捷径数量
+static int contractNode(ChBuilder& b, int v, bool simulate) {
+    const vector<ChArc> arcs = b.adj[v];
+    int shortcuts = 0;
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (i + 1 == arcs.size()) break;
+        int u = arcs[i].to;
+        double maxW = 0.0;
+        for (size_t j = i + 1; j < arcs.size(); ++j) maxW = max(maxW, arcs[i].w + arcs[j].w);
+        witnessSearch(b, u, v, maxW);
+        for (size_t j = i + 1; j < arcs.size(); ++j) {
+            int x = arcs[j].to;
+            double via = arcs[i].w + arcs[j].w;
+            if (b.wdist[x] <= via) continue;
+            ++shortcuts;
+            if (!simulate) {
+                addOrUpdateArc(b.adj[u], x, via, v);
+                addOrUpdateArc(b.adj[x], u, via, v);
+            }
+        }
+    }
+    return shortcuts;
+}
+
+// 节点重要度：边差（新增捷径 - 删除的弧）+ 已收缩邻居数
+static int nodePriority(ChBuilder& b, int v) {
+    int shortcuts = contractNode(b, v, true);
+    return shortcuts - (int)b.adj[v].size() + b.deletedNeighbors[v];
+}
+
+// 重要度小根堆元素
+struct PriorityItem {
+    int priority;
+    int node;
+    PriorityItem() : priority(0), node(0) {}
+    PriorityItem(int p, int v) : priority(p), node(v) {}
+};
+
+struct PriorityItemGreater {
+    bool operator()(const PriorityItem& a, const PriorityItem& b) const {
+        if (a.priority != b.priority) return a.priority > b.priority;
+        return a.node > b.node;
+    }
+};
+
+void buildContractionHierarchy(const CsrGraph& g, const vector<double>& w, ContractionHierarchy& ch) {
+    int n = g.n;
+    ChBuilder b;
+    b.n = n;
+    b.adj.assign(n + 1, vector<ChArc>());
+    b.contracted.assign(n + 1, 0);
+    b.deletedNeighbors.assign(n + 1, 0);
+    b.wdist.assign(n + 1, INF);
+
+    // 初始弧：去掉自环，平行边保留最小代价
+    for (int u = 1; u <= n; ++u) {
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            if (g.to[i] == u) continue;
+            addOrUpdateArc(b.adj[u], g.to[i], w[i], -1);
+        }
+    }
+
+    priority_queue<PriorityItem, vector<PriorityItem>, PriorityItemGreater> order;
+    for (int v = 1; v <= n; ++v) order.push(PriorityItem(nodePriority(b, v), v));
+
+    // 每个节点收缩时记录它指向剩余（更高层）邻居的弧
+    vector< vector<ChArc> > up(n + 1);
+    ch.rank.assign(n + 1, 0);
+    int nextRank = 0;
+    while (!order.empty()) {
+        PriorityItem top = order.top();
+        order.pop();
+        int v = top.node;
+        if (b.contracted[v]) continue;
+        // 惰性更新：重算后若不再最小则放回
+        int p = nodePriority(b, v);
+        if (!order.empty() && p > order.top().priority) {
+            order.push(PriorityItem(p, v));
+            continue;
+        }
+
+        up[v] = b.adj[v];
+        contractNode(b, v, false);
+        b.contracted[v] = 1;
+        ch.rank[v] = nextRank++;
+        for (size_t i = 0; i < up[v].size(); ++i) {
+            int u = up[v][i].to;
+            vector<ChArc>& arcs = b.adj[u];
+            for (size_t j = 0; j < arcs.size(); ++j) {
+                if (arcs[j].to == v) {
+                    arcs[j] = arcs.back();
+                    arcs.pop_back();
+                    break;
+                }
+            }
+            ++b.deletedNeighbors[u];
+        }
+        vector<ChArc>().swap(b.adj[v]);
+    }
+
+    // 向上弧压缩为 CSR
+    ch.n = n;
+    ch.m = g.m;
+    ch.weightChecksum = weightChecksum(w);
+    ch.upOffset.assign(n + 2, 0);
+    for (int v = 1; v <= n; ++v) ch.upOffset[v + 1] = ch.upOffset[v] + (int)up[v].size();
+    int total = ch.upOffset[n + 1];
+    ch.upTo.resize(total);
+    ch.upWeight.resize(total);
+    ch.upMiddle.resize(total);
+    for (int v = 1; v <= n; ++v) {
+        int k = ch.upOffset[v];
+        for (size_t i = 0; i < up[v].size(); ++i, ++k) {
+            ch.upTo[k] = up[v][i].to;
+            ch.upWeight[k] = up[v][i].w;
+            ch.upMiddle[k] = up[v][i].mid;
+        }
+    }
+}
+
+// 查找低层节点 low 指向 high 的向上弧下标
+static int findUpArc(const ContractionHierarchy& ch, int low, int high) {
+    for (int i = ch.upOffset[low]; i < ch.upOffset[low + 1]; ++i) {
+        if (ch.upTo[i] == high) return i;
+    }
+    return -1;
+}
+
+// 展开 a-b 之间的弧（a 已在路径末尾），把 a 之后直到 b 的节点追加到 path
+static void unpackArc(const ContractionHierarchy& ch, int a, int b, int mid, vector<int>& path) {
+    if (mid == -1) {
+        path.push_back(b);
+        return;
+    }
+    // 中间节点 mid 的层级低于 a、b，弧存放在 mid 上
+    int i1 = findUpArc(ch, mid, a);
+    int i2 = findUpArc(ch, mid, b);
+    unpackArc(ch, a, mid, ch.upMiddle[i1], path);
+    unpackArc(ch, mid, b, ch.upMiddle[i2], path);
+}
+
+bool chQuery(const ContractionHierarchy& ch, ChQueryWorkspace& ws, int s, int t, vector<int>& path, double& dist) {
+    path.clear();
+    dist = INF;
+    if ((int)ws.dist[0].size() != ch.n + 1) {
+        for (int d = 0; d < 2; ++d) {
+            ws.dist[d].assign(ch.n + 1, INF);
+            ws.parentArc[d].assign(ch.n + 1, -1);
+            ws.parentNode[d].assign(ch.n + 1, -1);
+        }
+        ws.touched.clear();
+    }
+    for (size_t i = 0; i < ws.touched.size(); ++i) {
+        int v = ws.touched[i];
+        for (int d = 0; d < 2; ++d) {
+            ws.dist[d][v] = INF;
+            ws.parentArc[d][v] = -1;
+            ws.parentNode[d][v] = -1;
+        }
+    }
+    ws.touched.clear();
+
+    int src[2] = { s, t };
+    for (int d = 0; d < 2; ++d) {
+        ws.heap[d].clear();
+        ws.dist[d][src[d]] = 0.0;
+        ws.heap[d].push_back(NodeDist(src[d], 0.0));
+        ws.touched.push_back(src[d]);
+    }
+
+    double best = INF;
+    int meet = -1;
+    NodeDistGreater cmp;
+    while (true) {
+        // 选择堆顶较小的一侧推进；两侧堆顶都不小于当前最优时停止
+        int d = -1;
+        double topKey = INF;
+        for (int k = 0; k < 2; ++k) {
+            if (!ws.heap[k].empty() && ws.heap[k].front().dist < topKey) {
+                topKey = ws.heap[k].front().dist;
+                d = k;
+            }
+        }
+        if (d == -1 || topKey >= best) break;
+
+        pop_heap(ws.heap[d].begin(), ws.heap[d].end(), cmp);
+        NodeDist cur = ws.heap[d].back();
+        ws.heap[d].pop_back();
+        int u = cur.node;
+        if (cur.dist != ws.dist[d][u]) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        PERF_INC(PERF_SETTLED);
+
+        double other = ws.dist[1 - d][u];
+        if (other != INF && cur.dist + other < best) {
+            best = cur.dist + other;
+            meet = u;
+        }
+        PERF_ADD(PERF_RELAXED, ch.upOffset[u + 1] - ch.upOffset[u]);
+        for (int i = ch.upOffset[u]; i < ch.upOffset[u + 1]; ++i) {
+            int v = ch.upTo[i];
+            double nd = cur.dist + ch.upWeight[i];
+            if (nd < ws.dist[d][v]) {
+                if (ws.dist[0][v] == INF && ws.dist[1][v] == INF) ws.touched.push_back(v);
+                ws.dist[d][v] = nd;
+                ws.parentArc[d][v] = i;
+                ws.parentNode[d][v] = u;
+                PERF_INC(PERF_PUSHES);
+                ws.heap[d].push_back(NodeDist(v, nd));
+                push_heap(ws.heap[d].begin(), ws.heap[d].end(), cmp);
+            }
+        }
+    }
+    if (meet == -1) return false;
+    dist = best;
+
+    // 正向：从 meet 回溯到 s，得到向上弧序列后逆序展开
+    vector<int> arcs;
+    for (int v = meet; v != s; v = ws.parentNode[0][v]) arcs.push_back(ws.parentArc[0][v]);
+    path.push_back(s);
+    int cur = s;
+    for (size_t k = arcs.size(); k-- > 0;) {
+        int i = arcs[k];
+        unpackArc(ch, cur, ch.upTo[i], ch.upMiddle[i], path);
+        cur = ch.upTo[i];
+    }
+    // 反向：从 meet 沿反向父指针一路向下到 t
+    for (int v = meet; v != t; v = ws.parentNode[1][v]) {
+        int i = ws.parentArc[1][v];
+        int low = ws.parentNode[1][v];
+        unpackArc(ch, v, low, ch.upMiddle[i], path);
+    }
+    return true;
+}
+
+static const unsigned long long FNV_OFFSET = 1469598103934665603ULL;
+
+// FNV-1a：把 bytes 个字节并入 h
+static unsigned long long fnvBytes(unsigned long long h, const void* data, size_t bytes) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < bytes; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+template <class T>
+static unsigned long long fnvArray(unsigned long long h, const vector<T>& a) {
+    return a.empty() ? h : fnvBytes(h, &a[0], a.size() * sizeof(T));
+}
+
+unsigned long long weightChecksum(const vector<double>& w) {
+    return fnvArray(FNV_OFFSET, w);
+}
+
+// 各数组内容的校验和，写在文件末尾：结构校验查不出的改动（如某条弧的代价）也能发现
+static unsigned long long contentChecksum(const ContractionHierarchy& ch) {
+    unsigned long long h = fnvArray(FNV_OFFSET, ch.rank);
+    h = fnvArray(h, ch.upOffset);
+    h = fnvArray(h, ch.upTo);
+    h = fnvArray(h, ch.upWeight);
+    return fnvArray(h, ch.upMiddle);
+}
+
+// 文件头：魔数 + 版本（02 起文件头含等待时间、重编号标志与边权校验和，文件末尾为内容校验和）
+static const char CH_MAGIC[8] = { 'C', 'H', 'R', 'O', 'A', 'D', '0', '2' };
+
+template <class T>
+static bool writeArray(FILE* f, const vector<T>& a) {
+    long long sz = (long long)a.size();
+    if (fwrite(&sz, sizeof(sz), 1, f) != 1) return false;
+    return a.empty() || fwrite(&a[0], sizeof(T), a.size(), f) == a.size();
+}
+
+// remaining：文件中尚未读取的字节数，长度字段超出时直接判为损坏，不按它分配内存
+template <class T>
+static bool readArray(FILE* f, long long& remaining, vector<T>& a) {
+    long long sz = 0;
+    if (fread(&sz, sizeof(sz), 1, f) != 1 || sz < 0) return false;
+    remaining -= (long long)sizeof(sz);
+    if (sz > remaining / (long long)sizeof(T)) return false;
+    remaining -= sz * (long long)sizeof(T);
+    a.resize((size_t)sz);
+    return a.empty() || fread(&a[0], sizeof(T), a.size(), f) == a.size();
+}
+
+// 加载后的结构校验：长度一致，upOffset 从 0 单调不减，弧指向更高层的有效节点，
+// 捷径的中间节点层级低于两端且两段弧都存在（保证展开逐层向下、必然终止），代价非负
+static bool validHierarchy(const ContractionHierarchy& ch) {
+    int n = ch.n;
+    if (n < 0 || ch.m < 0) return false;
+    if ((int)ch.rank.size() != n + 1 || (int)ch.upOffset.size() != n + 2) return false;
+    if (ch.upOffset[0] != 0 || ch.upOffset[1] != 0) return false;
+    for (int v = 1; v <= n; ++v) {
+        if (ch.upOffset[v] > ch.upOffset[v + 1]) return false;
+    }
+    size_t total = (size_t)ch.upOffset[n + 1];
+    if (ch.upTo.size() != total || ch.upWeight.size() != total || ch.upMiddle.size() != total) return false;
+    for (int v = 1; v <= n; ++v) {
+        for (int i = ch.upOffset[v]; i < ch.upOffset[v + 1]; ++i) {
+            int to = ch.upTo[i];
+            if (to < 1 || to > n || ch.rank[to] <= ch.rank[v]) return false;
+            if (!(ch.upWeight[i] >= 0.0)) return false;
+            int mid = ch.upMiddle[i];
+            if (mid == -1) continue;
+            if (mid < 1 || mid > n || ch.rank[mid] >= ch.rank[v]) return false;
+            if (findUpArc(ch, mid, v) == -1 || findUpArc(ch, mid, to) == -1) return false;
+        }
+    }
+    return true;
+}
+
+bool saveContractionHierarchy(const ContractionHierarchy& ch, const char* file) {
+    FILE* f = fopen(file, "wb");
+    if (!f) return false;
+    int reordered = ch.reordered ? 1 : 0;
+    bool ok = fwrite(CH_MAGIC, 1, sizeof(CH_MAGIC), f) == sizeof(CH_MAGIC)
+        && fwrite(&ch.n, sizeof(ch.n), 1, f) == 1
+        && fwrite(&ch.m, sizeof(ch.m), 1, f) == 1
+        && fwrite(&ch.lightWait, sizeof(ch.lightWait), 1, f) == 1
+        && fwrite(&reordered, sizeof(reordered), 1, f) == 1
+        && fwrite(&ch.weightChecksum, sizeof(ch.weightChecksum), 1, f) == 1
+        && writeArray(f, ch.rank) && writeArray(f, ch.upOffset)
+        && writeArray(f, ch.upTo) && writeArray(f, ch.upWeight) && writeArray(f, ch.upMiddle);
+    unsigned long long sum = contentChecksum(ch);
+    ok = ok && fwrite(&sum, sizeof(sum), 1, f) == 1;
+    fclose(f);
+    return ok;
+}
+
+bool loadContractionHierarchy(ContractionHierarchy& ch, const char* file) {
+    FILE* f = fopen(file, "rb");
+    if (!f) return false;
+    long long remaining = 0;
+    if (fseek(f, 0, SEEK_END) == 0) remaining = ftell(f);
+    rewind(f);
+    char magic[sizeof(CH_MAGIC)];
+    int reordered = 0;
+    long long headerBytes = (long long)(sizeof(magic) + sizeof(ch.n) + sizeof(ch.m) + sizeof(ch.lightWait) + sizeof(reordered) + sizeof(ch.weightChecksum));
+    remaining -= headerBytes;
+    bool ok = fread(magic, 1, sizeof(magic), f) == sizeof(magic) && memcmp(magic, CH_MAGIC, sizeof(magic)) == 0
+        && fread(&ch.n, sizeof(ch.n), 1, f) == 1
+        && fread(&ch.m, sizeof(ch.m), 1, f) == 1
+        && fread(&ch.lightWait, sizeof(ch.lightWait), 1, f) == 1
+        && fread(&reordered, sizeof(reordered), 1, f) == 1
+        && fread(&ch.weightChecksum, sizeof(ch.weightChecksum), 1, f) == 1
+        && readArray(f, remaining, ch.rank) && readArray(f, remaining, ch.upOffset)
+        && readArray(f, remaining, ch.upTo) && readArray(f, remaining, ch.upWeight) && readArray(f, remaining, ch.upMiddle);
+    unsigned long long sum = 0;
+    ok = ok && fread(&sum, sizeof(sum), 1, f) == 1;
+    fclose(f);
+    ch.reordered = reordered != 0;
+    return ok && sum == contentChecksum(ch) && validHierarchy(ch);
+}
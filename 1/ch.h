@@ -0,0 +1,50 @@
+#ifndef CH_H
+#define CH_H
+
+// 收缩层次（Contraction Hierarchies）模块
+// 预处理：按重要度逐个收缩节点，必要时添加捷径；查询：起终点各自只沿“向上”弧做双向搜索
+// 道路为无向图，因此正反两个方向共用同一份向上弧 CSR
+
+#include <vector>
+#include "graph.h"
+
+struct ContractionHierarchy {
+    int n;    // n：节点数（1..N）
+    int m;    // m：原图有向边数（用于加载时校验）
+    // 以下三项随文件保存，加载后由调用方与当前设置比对：边权随 --light-wait 变化，节点编号随 --reorder 变化
+    double lightWait;    // lightWait：预处理时的红绿灯等待秒数（由调用方填写）
+    bool reordered;    // reordered：预处理时是否按 RCM 序重编号（由调用方填写）
+    unsigned long long weightChecksum;    // weightChecksum：预处理所用边权的校验和（buildContractionHierarchy 填写）
+    std::vector<int> rank;    // rank[v]：收缩次序，越大越重要
+    std::vector<int> upOffset;    // upOffset：节点 v 的向上弧位于 [upOffset[v], upOffset[v+1])
+    std::vector<int> upTo;    // upTo：弧的高层端点
+    std::vector<double> upWeight;    // upWeight：弧的代价
+    std::vector<int> upMiddle;    // upMiddle：捷径的中间节点，原始边为 -1
+    ContractionHierarchy();
+};
+
+// 查询工作区：按触及列表复位，重复查询无需 O(N) 初始化
+struct ChQueryWorkspace {
+    std::vector<double> dist[2];    // dist[0]：正向；dist[1]：反向
+    std::vector<int> parentArc[2];    // parentArc：到达该点所用的向上弧下标
+    std::vector<int> parentNode[2];    // parentNode：该弧的低层端点
+    std::vector<int> touched;    // touched：本次查询写过的节点
+    std::vector<NodeDist> heap[2];
+};
+
+// 边权数组的校验和（FNV-1a，按字节），用于判断收缩层次文件是否对应当前边权
+unsigned long long weightChecksum(const std::vector<double>& w);
+
+// 预处理：对给定边权（按 CSR 边下标排列，如 g.length 或预计算的通行时间）构建收缩层次
+void buildContractionHierarchy(const CsrGraph& g, const std::vector<double>& w, ContractionHierarchy& ch);
+
+// 查询 s->t：双向向上搜索，结果路径已展开捷径，可直接交给 printPath
+bool chQuery(const ContractionHierarchy& ch, ChQueryWorkspace& ws, int s, int t, std::vector<int>& path, double& dist);
+
+// 序列化 / 反序列化（二进制，本机字节序）
+// 加载时逐项校验：各数组长度、upOffset 单调、端点与中间节点编号有效且层级关系正确，
+// 文件末尾另有内容校验和；截断或损坏的文件返回 false，不会导致越界访问或展开时无限递归
+bool saveContractionHierarchy(const ContractionHierarchy& ch, const char* file);
+bool loadContractionHierarchy(ContractionHierarchy& ch, const char* file);
+
+#endif
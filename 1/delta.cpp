@@ -0,0 +1,233 @@
+#include "delta.h"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <limits>
+#include <cstring>
+#include <cmath>
+
+using namespace std;
+
+static const double INF = numeric_limits<double>::infinity();
+
+// 非负 double 的位模式按无符号整数比较与数值比较一致，可用整数 CAS 实现原子取最小
+static unsigned long long toBits(double d) {
+    unsigned long long b;
+    memcpy(&b, &d, sizeof(b));
+    return b;
+}
+
+static double fromBits(unsigned long long b) {
+    double d;
+    memcpy(&d, &b, sizeof(d));
+    return d;
+}
+
+// 原子地令 cell = min(cell, d)，成功改进返回 true
+static bool atomicMin(atomic<unsigned long long>& cell, double d) {
+    unsigned long long nb = toBits(d);
+    unsigned long long cur = cell.load(memory_order_relaxed);
+    while (nb < cur) {
+        if (cell.compare_exchange_weak(cur, nb, memory_order_relaxed)) return true;
+    }
+    return false;
+}
+
+PhasePool::PhasePool(int threads) : threads_(threads < 1 ? 1 : threads), generation_(0), pending_(0), stop_(false), job_(0) {
+    for (int tid = 1; tid < threads_; ++tid) workers_.push_back(thread(&PhasePool::workerLoop, this, tid));
+}
+
+PhasePool::~PhasePool() {
+    {
+        lock_guard<mutex> lk(mu_);
+        stop_ = true;
+        ++generation_;
+    }
+    cv_.notify_all();
+    for (size_t i = 0; i < workers_.size(); ++i) workers_[i].join();
+}
+
+void PhasePool::run(const function<void(int)>& job) {
+    if (threads_ == 1) {
+        job(0);
+        return;
+    }
+    {
+        lock_guard<mutex> lk(mu_);
+        job_ = &job;
+        pending_ = threads_ - 1;
+        ++generation_;
+    }
+    cv_.notify_all();
+    job(0);
+    unique_lock<mutex> lk(mu_);
+    doneCv_.wait(lk, [this]() { return pending_ == 0; });
+}
+
+void PhasePool::workerLoop(int tid) {
+    long long seen = 0;
+    while (true) {
+        const function<void(int)>* job;
+        {
+            unique_lock<mutex> lk(mu_);
+            cv_.wait(lk, [this, seen]() { return generation_ != seen; });
+            seen = generation_;
+            if (stop_) return;
+            job = job_;
+        }
+        (*job)(tid);
+        {
+            lock_guard<mutex> lk(mu_);
+            if (--pending_ == 0) doneCv_.notify_one();
+        }
+    }
+}
+
+double suggestDelta(const CsrGraph& g, const vector<double>& w) {
+    if (g.m == 0) return 1.0;
+    double sum = 0.0;
+    for (int i = 0; i < g.m; ++i) sum += w[i];
+    double avg = sum / (double)g.m;
+    return avg > 0.0 ? avg : 1.0;
+}
+
+void deltaStepping(const CsrGraph& g, const vector<double>& w, int s, double delta, int threads, vector<int>& prevNode, vector<double>& dist) {
+    PhasePool pool(threads);
+    deltaStepping(g, w, s, delta, pool, prevNode, dist);
+}
+
+void deltaStepping(const CsrGraph& g, const vector<double>& w, int s, double delta, PhasePool& pool, vector<int>& prevNode, vector<double>& dist) {
+    int n = g.n;
+    if (!(delta > 0.0)) delta = suggestDelta(g, w);
+    // 最短路至多 n-1 条边，距离不超过 n*最大边权：桶宽不小于它的 1/MAX_DELTA_BUCKETS 时桶下标有界，double 转 size_t 不会溢出
+    double maxW = 0.0;
+    for (int i = 0; i < g.m; ++i) {
+        if (w[i] > maxW) maxW = w[i];
+    }
+    double floorDelta = (double)n * maxW / MAX_DELTA_BUCKETS;
+    if (delta < floorDelta) delta = floorDelta;
+    if (!(delta > 0.0)) delta = 1.0;
+    int T = pool.size();
+
+    vector< atomic<unsigned long long> > d(n + 1);
+    for (int v = 0; v <= n; ++v) d[v].store(toBits(INF), memory_order_relaxed);
+    d[s].store(toBits(0.0), memory_order_relaxed);
+
+    vector< vector<int> > buckets(1, vector<int>(1, s));
+    vector<int> inRound(n + 1, -1);    // inRound[v]：v 最近一次被纳入哪一轮（去重）
+    vector<int> inBucket(n + 1, -1);    // inBucket[v]：v 最近一次被纳入哪个桶的确定集合
+    vector< vector<int> > improved(T);    // 各线程本轮距离被改进的节点
+    vector<int> frontier;
+    vector<int> settled;
+    int round = 0;
+
+    // 把本轮各线程改进的节点按新距离放入对应的桶
+    function<void()> scatter = [&]() {
+        for (int tid = 0; tid < T; ++tid) {
+            for (size_t k = 0; k < improved[tid].size(); ++k) {
+                int v = improved[tid][k];
+                size_t b = (size_t)(fromBits(d[v].load(memory_order_relaxed)) / delta);
+                if (b >= buckets.size()) buckets.resize(b + 1);
+                buckets[b].push_back(v);
+            }
+            improved[tid].clear();
+        }
+    };
+
+    // 并行松弛 nodes 中各节点的出边：light=true 只松弛 w<=delta，否则只松弛 w>delta
+    bool light = true;
+    const vector<int>* nodes = &frontier;
+    function<void(int)> relaxJob = [&](int tid) {
+        const vector<int>& list = *nodes;
+        size_t cnt = list.size();
+        size_t begin = cnt * tid / T, end = cnt * (tid + 1) / T;
+        vector<int>& out = improved[tid];
+        for (size_t k = begin; k < end; ++k) {
+            int u = list[k];
+            double du = fromBits(d[u].load(memory_order_relaxed));
+            for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+                if ((w[i] <= delta) != light) continue;
+                if (atomicMin(d[g.to[i]], du + w[i])) out.push_back(g.to[i]);
+            }
+        }
+    };
+
+    for (size_t b = 0; b < buckets.size(); ++b) {
+        settled.clear();
+        while (!buckets[b].empty()) {
+            // 取出本桶当前内容：过滤已移到其他桶的过期记录与重复记录
+            frontier.clear();
+            ++round;
+            for (size_t k = 0; k < buckets[b].size(); ++k) {
+                int v = buckets[b][k];
+                if (inRound[v] == round) continue;
+                if ((size_t)(fromBits(d[v].load(memory_order_relaxed)) / delta) != b) continue;
+                inRound[v] = round;
+                frontier.push_back(v);
+                if (inBucket[v] != (int)b) {
+                    inBucket[v] = (int)b;
+                    settled.push_back(v);
+                }
+            }
+            buckets[b].clear();
+            light = true;
+            nodes = &frontier;
+            pool.run(relaxJob);
+            scatter();
+        }
+        // 本桶节点已确定，统一松弛重边
+        light = false;
+        nodes = &settled;
+        pool.run(relaxJob);
+        scatter();
+        vector<int>().swap(buckets[b]);
+    }
+
+    dist.assign(n + 1, INF);
+    for (int v = 0; v <= n; ++v) dist[v] = fromBits(d[v].load(memory_order_relaxed));
+
+    // 并行选取前驱：满足 dist[u] + w == dist[v] 且 dist[u] < dist[v] 的邻居中编号最小者（无向图两方向边权相同）
+    // 前驱的距离严格更小，沿前驱不会成环；只能经零权边从等距离的邻居到达的节点留到下面补选
+    prevNode.assign(n + 1, -1);
+    function<void(int)> parentJob = [&](int tid) {
+        int begin = 1 + (int)((long long)n * tid / T), end = 1 + (int)((long long)n * (tid + 1) / T);
+        for (int v = begin; v < end; ++v) {
+            if (v == s || dist[v] == INF) continue;
+            int best = -1;
+            for (int i = g.offset[v]; i < g.offset[v + 1]; ++i) {
+                int u = g.to[i];
+                if (u == v || dist[u] + w[i] != dist[v] || dist[u] == dist[v]) continue;
+                if (best == -1 || u < best) best = u;
+            }
+            prevNode[v] = best;
+        }
+    };
+    pool.run(parentJob);
+
+    // 补选：等距离的紧边只出现在零权边上，从已有前驱的节点出发沿这些边 BFS，先到者为前驱（只涉及零权边连成的分量）
+    vector<int> queue;
+    for (int v = 1; v <= n; ++v) {
+        if (v == s || dist[v] == INF || prevNode[v] != -1) continue;
+        int best = -1;
+        for (int i = g.offset[v]; i < g.offset[v + 1]; ++i) {
+            int u = g.to[i];
+            if (u == v || dist[u] != dist[v] || dist[u] + w[i] != dist[v]) continue;
+            if (u != s && prevNode[u] == -1) continue;
+            if (best == -1 || u < best) best = u;
+        }
+        if (best == -1) continue;
+        prevNode[v] = best;
+        queue.push_back(v);
+    }
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int u = queue[head];
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            if (v == s || prevNode[v] != -1 || dist[v] != dist[u] || dist[u] + w[i] != dist[v]) continue;
+            prevNode[v] = u;
+            queue.push_back(v);
+        }
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef DELTA_H
+#define DELTA_H
+
+// 并行 delta-stepping 单源最短路（一对全部，用于等时圈、站点覆盖等）
+// 按 delta 宽度把暂定距离分桶，逐桶处理：桶内反复并行松弛轻边（w <= delta）直到桶空，
+// 再一次性并行松弛本桶确定节点的重边；距离用原子比较交换取最小值
+// 距离全部确定后再并行为每个节点选取前驱（满足 dist[u] + w == dist[v] 且 dist[u] < dist[v] 的编号最小的邻居；
+// 只能经零权边到达的节点再沿零权边 BFS 补选），因此 dist 与 dijkstra 完全一致；
+// 最短路唯一时 prevNode 也一致，否则为另一棵合法的最短路树（有零权边时也无环）
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "graph.h"
+
+// 常驻线程池：每个阶段由主线程发布任务 job(tid)，主线程自己执行 tid=0，等待其余线程完成
+// 线程在构造时创建、析构时回收，多次查询应共用同一个池
+class PhasePool {
+public:
+    explicit PhasePool(int threads);
+    ~PhasePool();
+    int size() const { return threads_; }
+    void run(const std::function<void(int)>& job);
+
+private:
+    PhasePool(const PhasePool&);
+    PhasePool& operator=(const PhasePool&);
+    void workerLoop(int tid);
+
+    int threads_;
+    std::vector<std::thread> workers_;
+    std::mutex mu_;
+    std::condition_variable cv_;
+    std::condition_variable doneCv_;
+    long long generation_;
+    int pending_;
+    bool stop_;
+    const std::function<void(int)>* job_;
+};
+
+// 建议的桶宽：平均边权（轻边占多数，桶内轮数较少）
+double suggestDelta(const CsrGraph& g, const std::vector<double>& w);
+
+// 桶数上限：桶宽过小时（桶数约为最大距离/桶宽）按 n*最大边权/上限 抬高桶宽，避免巨量分配与下标溢出
+static const double MAX_DELTA_BUCKETS = 1 << 20;
+
+// w：按 CSR 边下标排列的边权；delta <= 0 时取 suggestDelta；各阶段在 pool 的线程上并行
+// 输出 dist/prevNode 大小为 n+1，不可达为无穷大 / -1
+void deltaStepping(const CsrGraph& g, const std::vector<double>& w, int s, double delta, PhasePool& pool, std::vector<int>& prevNode, std::vector<double>& dist);
+
+// 同上，临时创建 threads 个线程的池（单次调用；多次查询请共用 PhasePool）
+void deltaStepping(const CsrGraph& g, const std::vector<double>& w, int s, double delta, int threads, std::vector<int>& prevNode, std::vector<double>& dist);
+
+#endif
@@ -0,0 +1,146 @@
+#include "dynamic.h"
+#include "../common/parallel.h"
+#include <algorithm>
+#include <limits>
+
+using namespace std;
+
+static const double INF = numeric_limits<double>::infinity();
+
+EdgeChange::EdgeChange() : slot(-1), oldWeight(0) {}
+EdgeChange::EdgeChange(int s, double w) : slot(s), oldWeight(w) {}
+
+ShortestPathTree::ShortestPathTree() : source(0), epoch(0) {}
+
+bool updateRoadTraffic(CsrGraph& g, int road, double congestion, int lights, double lightWait, vector<double>& timeWeights, vector<EdgeChange>& changes) {
+    if (road < 0 || 2 * road + 1 >= (int)g.roadSlot.size() || g.roadSlot[2 * road] == -1) return false;
+    if (g.congestion.borrowed()) return false;    // 映射的快照为只读内存
+    if (congestion < 1.0) congestion = 1.0;
+    TravelTimeCost cost(lightWait);
+    for (int k = 0; k < 2; ++k) {
+        int i = g.roadSlot[2 * road + k];
+        g.congestion[i] = congestion;
+        g.lights[i] = lights;
+        changes.push_back(EdgeChange(i, timeWeights[i]));
+        timeWeights[i] = cost(g, i);
+    }
+    return true;
+}
+
+// 从已入堆的种子继续 Dijkstra 传播（惰性删除：出堆距离与当前值不符即跳过）
+static void propagate(const CsrGraph& g, const vector<double>& w, ShortestPathTree& tree) {
+    vector<NodeDist>& heap = tree.heap;
+    NodeDistGreater cmp;
+    while (!heap.empty()) {
+        pop_heap(heap.begin(), heap.end(), cmp);
+        NodeDist cur = heap.back();
+        heap.pop_back();
+        int u = cur.node;
+        if (cur.dist != tree.dist[u]) continue;
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = cur.dist + w[i];
+            if (nd < tree.dist[v]) {
+                tree.dist[v] = nd;
+                tree.prevNode[v] = u;
+                heap.push_back(NodeDist(v, nd));
+                push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+}
+
+void buildShortestPathTree(const CsrGraph& g, const vector<double>& w, int source, ShortestPathTree& tree) {
+    tree.source = source;
+    tree.dist.assign(g.n + 1, INF);
+    tree.prevNode.assign(g.n + 1, -1);
+    tree.mark.assign(g.n + 1, 0);
+    tree.epoch = 0;
+    tree.heap.clear();
+    tree.dist[source] = 0.0;
+    tree.heap.push_back(NodeDist(source, 0.0));
+    propagate(g, w, tree);
+}
+
+void repairShortestPathTree(const CsrGraph& g, const vector<double>& w, const vector<EdgeChange>& changes, ShortestPathTree& tree) {
+    if (++tree.epoch == 0) {
+        tree.mark.assign(tree.mark.size(), 0);
+        tree.epoch = 1;
+    }
+    const unsigned ep = tree.epoch;
+    NodeDistGreater cmp;
+    tree.heap.clear();
+    tree.affected.clear();
+
+    // 1. 变大的树边：记录其下游端点为受影响子树的根
+    for (size_t k = 0; k < changes.size(); ++k) {
+        int i = changes[k].slot;
+        if (w[i] <= changes[k].oldWeight) continue;
+        int v = g.to[i];
+        if (tree.mark[v] == ep || tree.prevNode[v] == -1) continue;
+        int u = tree.prevNode[v];
+        // 父节点的出边中 i 指向 v 且距离恰好由旧边权得到，才认为是树边（平行边时保守处理）
+        if (i < g.offset[u] || i >= g.offset[u + 1]) continue;
+        if (tree.dist[u] + changes[k].oldWeight != tree.dist[v]) continue;
+        tree.mark[v] = ep;
+        tree.affected.push_back(v);
+    }
+
+    // 2. 沿父子关系收集整棵受影响子树（孩子 x 满足 prevNode[x] == y）
+    for (size_t h = 0; h < tree.affected.size(); ++h) {
+        int y = tree.affected[h];
+        for (int i = g.offset[y]; i < g.offset[y + 1]; ++i) {
+            int x = g.to[i];
+            if (tree.prevNode[x] == y && tree.mark[x] != ep) {
+                tree.mark[x] = ep;
+                tree.affected.push_back(x);
+            }
+        }
+    }
+    for (size_t h = 0; h < tree.affected.size(); ++h) {
+        int a = tree.affected[h];
+        tree.dist[a] = INF;
+        tree.prevNode[a] = -1;
+    }
+
+    // 3. 受影响节点从未受影响的邻居取候选距离（无向图两方向边权相同）
+    for (size_t h = 0; h < tree.affected.size(); ++h) {
+        int a = tree.affected[h];
+        for (int i = g.offset[a]; i < g.offset[a + 1]; ++i) {
+            int y = g.to[i];
+            if (tree.mark[y] == ep || tree.dist[y] == INF) continue;
+            double nd = tree.dist[y] + w[i];
+            if (nd < tree.dist[a]) {
+                tree.dist[a] = nd;
+                tree.prevNode[a] = y;
+            }
+        }
+        if (tree.dist[a] != INF) tree.heap.push_back(NodeDist(a, tree.dist[a]));
+    }
+
+    // 4. 变小的边：能改进端点距离则作为种子
+    for (size_t k = 0; k < changes.size(); ++k) {
+        int i = changes[k].slot;
+        if (w[i] >= changes[k].oldWeight) continue;
+        int v = g.to[i];
+        // 找到边 i 的起点：i 位于哪个节点的出边区间
+        int u = (int)(upper_bound(g.offset.begin(), g.offset.end(), i) - g.offset.begin()) - 1;
+        if (tree.dist[u] == INF) continue;
+        double nd = tree.dist[u] + w[i];
+        if (nd < tree.dist[v]) {
+            tree.dist[v] = nd;
+            tree.prevNode[v] = u;
+            tree.heap.push_back(NodeDist(v, nd));
+        }
+    }
+
+    // 5. 从所有种子做局部传播
+    make_heap(tree.heap.begin(), tree.heap.end(), cmp);
+    propagate(g, w, tree);
+}
+
+void repairShortestPathTrees(const CsrGraph& g, const vector<double>& w, const vector<EdgeChange>& changes, vector<ShortestPathTree>& trees, int threads) {
+    parallelFor((int)trees.size(), threads, [&](int k, int) {
+        repairShortestPathTree(g, w, changes, trees[k]);
+    });
+}
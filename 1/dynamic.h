@@ -0,0 +1,46 @@
+#ifndef DYNAMIC_H
+#define DYNAMIC_H
+
+// 动态最短路模块：道路拥堵/红绿灯在线变化时，增量修复固定起点的最短路树（Ramalingam–Reps 思路）
+// - 边权变大且该边在树上：只有其下游子树受影响，先整体作废，再从未受影响的邻居取候选值
+// - 边权变小：若能改进端点距离则直接作为种子
+// 最后以所有种子为起点做一次局部 Dijkstra 传播，访问范围只限于距离实际发生变化的区域
+// 只有加权通行时间（mode=1）依赖拥堵与红绿灯，按长度的最短路树不受影响
+
+#include <vector>
+#include "graph.h"
+
+// 一条边权变化：slot 为 CSR 边下标，oldWeight 为变化前的边权
+struct EdgeChange {
+    int slot;
+    double oldWeight;
+    EdgeChange();
+    EdgeChange(int s, double w);
+};
+
+// 固定起点的最短路树
+struct ShortestPathTree {
+    int source;    // source：起点
+    std::vector<double> dist;    // dist：到各点的最短代价
+    std::vector<int> prevNode;    // prevNode：树上的父节点（起点与不可达点为 -1）
+    std::vector<unsigned> mark;    // mark：修复时标记受影响节点（时间戳）
+    unsigned epoch;
+    std::vector<NodeDist> heap;
+    std::vector<int> affected;
+    ShortestPathTree();
+};
+
+// 原地修改第 road 条输入道路（0 起）的拥堵系数与红绿灯数，并按 lightWait 同步更新加权通行时间边权 timeWeights
+// 两个方向的边及其旧边权追加到 changes；道路编号无效或图借用只读快照内存时返回 false
+bool updateRoadTraffic(CsrGraph& g, int road, double congestion, int lights, double lightWait, std::vector<double>& timeWeights, std::vector<EdgeChange>& changes);
+
+// 从头构建起点 source 的最短路树（w 为按 CSR 边下标排列的边权）
+void buildShortestPathTree(const CsrGraph& g, const std::vector<double>& w, int source, ShortestPathTree& tree);
+
+// 边权已更新为 w 后，根据 changes 增量修复最短路树
+void repairShortestPathTree(const CsrGraph& g, const std::vector<double>& w, const std::vector<EdgeChange>& changes, ShortestPathTree& tree);
+
+// 对多棵最短路树（如数百个固定起点）并行修复
+void repairShortestPathTrees(const CsrGraph& g, const std::vector<double>& w, const std::vector<EdgeChange>& changes, std::vector<ShortestPathTree>& trees, int threads);
+
+#endif
@@ -0,0 +1,220 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+// Dijkstra 前沿（优先队列）的可替换实现
+// 统一接口：prepare(n) / clear() / empty() / push(v, key) / pop() / pushes
+// - BinaryHeapFrontier：二叉堆 + 惰性删除（每次改进都压入一条新记录）
+// - QuaternaryHeapFrontier：带位置索引的 4 叉堆，真正的 decrease-key，堆中每个节点至多一条记录
+// - RadixHeapFrontier：单调基数堆，要求键为非负整数（见 quantizeWeights），弹出顺序单调不减
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include "graph.h"
+
+// 二叉堆（惰性删除），与 DijkstraWorkspace 默认使用的堆相同
+struct BinaryHeapFrontier {
+    std::vector<NodeDist> heap;
+    long long pushes;
+    BinaryHeapFrontier() : pushes(0) {}
+    void prepare(int) {}
+    void clear() { heap.clear(); }
+    bool empty() const { return heap.empty(); }
+    void push(int v, double key) {
+        ++pushes;
+        heap.push_back(NodeDist(v, key));
+        std::push_heap(heap.begin(), heap.end(), NodeDistGreater());
+    }
+    int pop() {
+        std::pop_heap(heap.begin(), heap.end(), NodeDistGreater());
+        int v = heap.back().node;
+        heap.pop_back();
+        return v;
+    }
+};
+
+// 带索引的 4 叉堆：pos[v] 为 v 在堆中的下标（-1 表示不在堆中）
+struct QuaternaryHeapFrontier {
+    std::vector<NodeDist> heap;
+    std::vector<int> pos;
+    long long pushes;
+    QuaternaryHeapFrontier() : pushes(0) {}
+    void prepare(int n) {
+        if ((int)pos.size() < n + 1) pos.resize(n + 1, -1);
+    }
+    // 只复位仍留在堆中的节点，代价与堆大小成正比
+    void clear() {
+        for (size_t i = 0; i < heap.size(); ++i) pos[heap[i].node] = -1;
+        heap.clear();
+    }
+    bool empty() const { return heap.empty(); }
+    // 不在堆中则插入，否则在键变小时执行 decrease-key
+    void push(int v, double key) {
+        int i = pos[v];
+        if (i == -1) {
+            ++pushes;
+            i = (int)heap.size();
+            heap.push_back(NodeDist(v, key));
+        } else if (key < heap[i].dist) {
+            heap[i].dist = key;
+        } else {
+            return;
+        }
+        siftUp(i);
+    }
+    int pop() {
+        int v = heap[0].node;
+        pos[v] = -1;
+        NodeDist last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            heap[0] = last;
+            pos[last.node] = 0;
+            siftDown(0);
+        }
+        return v;
+    }
+    void siftUp(int i) {
+        NodeDist x = heap[i];
+        while (i > 0) {
+            int p = (i - 1) >> 2;
+            if (heap[p].dist <= x.dist) break;
+            heap[i] = heap[p];
+            pos[heap[i].node] = i;
+            i = p;
+        }
+        heap[i] = x;
+        pos[x.node] = i;
+    }
+    void siftDown(int i) {
+        NodeDist x = heap[i];
+        int n = (int)heap.size();
+        while (true) {
+            int c = (i << 2) + 1;
+            if (c >= n) break;
+            int best = c;
+            int end = std::min(c + 4, n);
+            for (int k = c + 1; k < end; ++k) {
+                if (heap[k].dist < heap[best].dist) best = k;
+            }
+            if (heap[best].dist >= x.dist) break;
+            heap[i] = heap[best];
+            pos[heap[i].node] = i;
+            i = best;
+        }
+        heap[i] = x;
+        pos[x.node] = i;
+    }
+};
+
+// 单调基数堆：键为非负整数（以 double 存放、数值精确），桶 b 存放与 last 最高不同位为 b-1 的键
+struct RadixHeapFrontier {
+    struct Item {
+        int node;
+        unsigned long long key;
+        Item() : node(0), key(0) {}
+        Item(int v, unsigned long long k) : node(v), key(k) {}
+    };
+    std::vector<Item> buckets[65];
+    unsigned long long last;    // last：最近弹出的键
+    int count;
+    long long pushes;
+    RadixHeapFrontier() : last(0), count(0), pushes(0) {}
+    void prepare(int) {}
+    void clear() {
+        for (int b = 0; b < 65; ++b) buckets[b].clear();
+        last = 0;
+        count = 0;
+    }
+    bool empty() const { return count == 0; }
+    static int bucketOf(unsigned long long key, unsigned long long base) {
+        unsigned long long x = key ^ base;
+        if (x == 0) return 0;
+#ifdef __GNUC__
+        return 64 - __builtin_clzll(x);
+#else
+        int b = 0;
+        while (x) {
+            ++b;
+            x >>= 1;
+        }
+        return b;
+#endif
+    }
+    void push(int v, double key) {
+        ++pushes;
+        unsigned long long k = (unsigned long long)key;
+        buckets[bucketOf(k, last)].push_back(Item(v, k));
+        ++count;
+    }
+    int pop() {
+        if (buckets[0].empty()) {
+            int b = 1;
+            while (buckets[b].empty()) ++b;
+            // 以桶内最小键为新的 last，把该桶重新分配到更低的桶
+            unsigned long long mn = buckets[b][0].key;
+            for (size_t i = 1; i < buckets[b].size(); ++i) mn = std::min(mn, buckets[b][i].key);
+            last = mn;
+            for (size_t i = 0; i < buckets[b].size(); ++i) {
+                buckets[bucketOf(buckets[b][i].key, last)].push_back(buckets[b][i]);
+            }
+            buckets[b].clear();
+        }
+        int v = buckets[0].back().node;
+        buckets[0].pop_back();
+        --count;
+        return v;
+    }
+};
+
+// 把边权按 unitsPerCost 缩放并四舍五入为整数（如 1000 表示毫米/毫秒精度），供基数堆使用
+// 查询得到的距离需再除以 unitsPerCost
+inline void quantizeWeights(const std::vector<double>& w, double unitsPerCost, std::vector<double>& q) {
+    q.resize(w.size());
+    for (size_t i = 0; i < w.size(); ++i) q[i] = std::floor(w[i] * unitsPerCost + 0.5);
+}
+
+// Dijkstra 最短路（可替换前沿版本）：结果写入工作区，pq 由调用方持有以便复用
+template <class Cost, class Frontier>
+bool dijkstra(const CsrGraph& g, const Cost& cost, int s, int t, DijkstraWorkspace& ws, Frontier& pq, long long* settled = 0) {
+    ws.begin(g.n);
+    const unsigned ep = ws.epoch;
+    pq.prepare(g.n);
+    pq.clear();
+    if (settled) *settled = 0;
+
+    ws.dist[s] = 0.0;
+    ws.prevNode[s] = -1;
+    ws.stamp[s] = ep;
+    pq.push(s, 0.0);
+
+    while (!pq.empty()) {
+        int u = pq.pop();
+        if (ws.doneStamp[u] == ep) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        ws.doneStamp[u] = ep;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        if (u == t) break;
+
+        double du = ws.dist[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + cost(g, i);
+            if (ws.stamp[v] != ep || nd < ws.dist[v]) {
+                ws.stamp[v] = ep;
+                ws.dist[v] = nd;
+                ws.prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
+                pq.push(v, nd);
+            }
+        }
+    }
+
+    return ws.stamp[t] == ep;
+}
+
+#endif
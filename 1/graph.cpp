@@ -1,7 +1,10 @@
 #include "graph.h"
+#include "../common/parallel.h"
 #include <queue>
 #include <limits>
 #include <iostream>
+#include <algorithm>
+#include <cstring>
 
 using namespace std;
 
@@ -9,28 +12,17 @@ using namespace std;
 Edge::Edge() : to(0), length(0), congestion(1), lights(0) {}
 Edge::Edge(int t, double len, double cong, int l) : to(t), length(len), congestion(cong), lights(l) {}
 
-static const double LIGHT_WAIT_SECONDS = 30.0;
+// 道路结构体构造
+Road::Road() : u(0), v(0), length(0), congestion(1), lights(0) {}
+Road::Road(int a, int b, double len, double cong, int l) : u(a), v(b), length(len), congestion(cong), lights(l) {}
 
-// Dijkstra 用的节点-距离结构（用于优先队列）
-struct NodeDist {
-    int node;
-    double dist;
-    NodeDist() : node(0), dist(0) {}
-    NodeDist(int n, double d) : node(n), dist(d) {}
-};
-
-// 小根堆比较器
-struct NodeDistGreater {
-    bool operator()(const NodeDist& a, const NodeDist& b) const {
-        return a.dist > b.dist;
-    }
-};
+CsrGraph::CsrGraph() : n(0), m(0) {}
 
 // 统一边权计算
 static double edgeWeight(const Edge& e, int mode) {
     if (mode == 1) {
         // 加权模式：长度*拥堵+红绿灯等待（30秒/灯）
-        return e.length * e.congestion + (double)e.lights * LIGHT_WAIT_SECONDS;
+        return e.length * e.congestion + (double)e.lights * DEFAULT_LIGHT_WAIT_SECONDS;
     }
     return e.length;
 }
@@ -51,10 +43,15 @@ bool dijkstra(const vector< vector<Edge> >& g, int s, int t, int mode, vector<in
         NodeDist cur = pq.top();
         pq.pop();
         int u = cur.node;
-        if (used[u]) continue;
+        if (used[u]) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
         used[u] = 1;
+        PERF_INC(PERF_SETTLED);
         if (u == t) break;
 
+        PERF_ADD(PERF_RELAXED, g[u].size());
         for (size_t i = 0; i < g[u].size(); ++i) {
             const Edge& e = g[u][i];
             int v = e.to;
@@ -62,6 +59,7 @@ bool dijkstra(const vector< vector<Edge> >& g, int s, int t, int mode, vector<in
             if (dist[u] + w < dist[v]) {
                 dist[v] = dist[u] + w;
                 prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
                 pq.push(NodeDist(v, dist[v]));
             }
         }
@@ -70,6 +68,323 @@ bool dijkstra(const vector< vector<Edge> >& g, int s, int t, int mode, vector<in
     return dist[t] != numeric_limits<double>::infinity();
 }
 
+// 构建 CSR 图：先统计度数得到 offset，再按道路顺序填入各字段
+void buildCsrGraph(int n, const vector<Road>& roads, CsrGraph& g) {
+    g.n = n;
+    g.offset.assign(n + 2, 0);
+    for (size_t i = 0; i < roads.size(); ++i) {
+        const Road& r = roads[i];
+        if (r.u < 1 || r.u > n || r.v < 1 || r.v > n) continue;
+        ++g.offset[r.u + 1];
+        ++g.offset[r.v + 1];
+    }
+    for (int u = 1; u <= n + 1; ++u) g.offset[u] += g.offset[u - 1];
+    g.m = g.offset[n + 1];
+
+    g.to.assign(g.m, 0);
+    g.length.assign(g.m, 0.0);
+    g.congestion.assign(g.m, 1.0);
+    g.lights.assign(g.m, 0);
+
+    g.roadSlot.assign(roads.size() * 2, -1);
+
+    vector<int> cursor(g.offset.begin(), g.offset.end() - 1); // 各节点当前写入位置
+    for (size_t i = 0; i < roads.size(); ++i) {
+        const Road& r = roads[i];
+        if (r.u < 1 || r.u > n || r.v < 1 || r.v > n) continue;
+        double cong = r.congestion < 1.0 ? 1.0 : r.congestion;
+        int a = cursor[r.u]++;
+        g.to[a] = r.v; g.length[a] = r.length; g.congestion[a] = cong; g.lights[a] = r.lights;
+        int b = cursor[r.v]++;
+        g.to[b] = r.u; g.length[b] = r.length; g.congestion[b] = cong; g.lights[b] = r.lights;
+        g.roadSlot[2 * i] = a;
+        g.roadSlot[2 * i + 1] = b;
+    }
+}
+
+// Dijkstra 最短路径（CSR 图）：按 mode 选择代价策略后进入模板版本
+bool dijkstra(const CsrGraph& g, int s, int t, int mode, vector<int>& prevNode, vector<double>& dist) {
+    if (mode == 1) return dijkstra(g, TravelTimeCost(DEFAULT_LIGHT_WAIT_SECONDS), s, t, prevNode, dist);
+    return dijkstra(g, LengthCost(), s, t, prevNode, dist);
+}
+
+AltLandmarks::AltLandmarks() : k(0) {}
+
+static const double INF = numeric_limits<double>::infinity();
+
+DijkstraWorkspace::DijkstraWorkspace() : epoch(0) {}
+
+void DijkstraWorkspace::begin(int n) {
+    if ((int)stamp.size() < n + 1) {
+        dist.resize(n + 1);
+        prevNode.resize(n + 1);
+        stamp.resize(n + 1, 0);
+        doneStamp.resize(n + 1, 0);
+        targetStamp.resize(n + 1, 0);
+    }
+    heap.clear();
+    if (++epoch == 0) {
+        // epoch 回绕：旧时间戳可能与新值冲突，整体清零一次
+        stamp.assign(stamp.size(), 0);
+        doneStamp.assign(doneStamp.size(), 0);
+        targetStamp.assign(targetStamp.size(), 0);
+        epoch = 1;
+    }
+}
+
+double DijkstraWorkspace::distOf(int v) const {
+    return stamp[v] == epoch ? dist[v] : INF;
+}
+
+int DijkstraWorkspace::prevOf(int v) const {
+    return stamp[v] == epoch ? prevNode[v] : -1;
+}
+
+// 双向 Dijkstra：dist/prevNode 存正向结果，反向使用独立数组；相遇后把反向前驱拼接到 prevNode
+bool bidirectionalDijkstra(const CsrGraph& g, const vector<double>& w, int s, int t, vector<int>& prevNode, vector<double>& dist, long long* settled) {
+    int n = g.n;
+    dist.assign(n + 1, INF);
+    prevNode.assign(n + 1, -1);
+    vector<double> distB(n + 1, INF);
+    vector<int> nextB(n + 1, -1); // 反向搜索的前驱，即正向路径上的后继
+    vector<char> used[2];
+    used[0].assign(n + 1, 0);
+    used[1].assign(n + 1, 0);
+    vector<double>* d[2] = { &dist, &distB };
+    vector<int>* par[2] = { &prevNode, &nextB };
+    priority_queue<NodeDist, vector<NodeDist>, NodeDistGreater> pq[2];
+    if (settled) *settled = 0;
+
+    dist[s] = 0.0;
+    distB[t] = 0.0;
+    pq[0].push(NodeDist(s, 0.0));
+    pq[1].push(NodeDist(t, 0.0));
+
+    double best = (s == t) ? 0.0 : INF;
+    int meet = (s == t) ? s : -1;
+    while (!pq[0].empty() && !pq[1].empty()) {
+        // 标准停止条件：两侧堆顶之和不小于当前最优值
+        if (pq[0].top().dist + pq[1].top().dist >= best) break;
+        int side = pq[0].size() <= pq[1].size() ? 0 : 1;
+        NodeDist cur = pq[side].top();
+        pq[side].pop();
+        int u = cur.node;
+        if (used[side][u]) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        used[side][u] = 1;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+
+        vector<double>& ds = *d[side];
+        const vector<double>& dOther = *d[1 - side];
+        double du = ds[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + w[i];
+            if (nd < ds[v]) {
+                ds[v] = nd;
+                (*par[side])[v] = u;
+                PERF_INC(PERF_PUSHES);
+                pq[side].push(NodeDist(v, nd));
+            }
+            if (dOther[v] != INF && nd + dOther[v] < best) {
+                best = nd + dOther[v];
+                meet = v;
+            }
+        }
+    }
+    if (meet == -1) return false;
+
+    // meet 之后的半段沿反向前驱走到 t，改写为正向前驱
+    for (int v = meet; v != t; v = nextB[v]) {
+        int nx = nextB[v];
+        prevNode[nx] = v;
+    }
+    if (meet != t) dist[t] = best;
+    return true;
+}
+
+// 距离矩阵：每行一次多终点搜索，行间并行；每个线程持有自己的工作区
+void distanceMatrix(const CsrGraph& g, const vector<double>& w, const vector<int>& sources, const vector<int>& targets, vector<double>& out, int threads) {
+    int rows = (int)sources.size();
+    int cols = (int)targets.size();
+    out.assign((size_t)rows * (size_t)cols, INF);
+    if (rows == 0 || cols == 0) return;
+
+    // 编号无效的终点不参与搜索，对应列保持无穷大
+    vector<int> validTargets;
+    for (int j = 0; j < cols; ++j) {
+        if (targets[j] >= 1 && targets[j] <= g.n) validTargets.push_back(targets[j]);
+    }
+    if (threads < 1) threads = 1;
+    vector<DijkstraWorkspace> ws(threads);
+    PrecomputedCost cost(w);
+
+    parallelFor(rows, threads, [&](int i, int tid) {
+        int s = sources[i];
+        if (s < 1 || s > g.n) return;
+        dijkstraToTargets(g, cost, s, validTargets, ws[tid]);
+        double* row = &out[(size_t)i * cols];
+        for (int j = 0; j < cols; ++j) {
+            int t = targets[j];
+            if (t >= 1 && t <= g.n) row[j] = ws[tid].distOf(t);
+        }
+    });
+}
+
+void distanceMatrix(const CsrGraph& g, const vector<int>& sources, const vector<int>& targets, int mode, vector<double>& out, int threads) {
+    if (mode == 1) {
+        vector<double> w;
+        precomputeWeights(g, TravelTimeCost(DEFAULT_LIGHT_WAIT_SECONDS), w);
+        distanceMatrix(g, w, sources, targets, out, threads);
+    } else {
+        vector<double> w;
+        precomputeWeights(g, LengthCost(), w);
+        distanceMatrix(g, w, sources, targets, out, threads);
+    }
+}
+
+bool writeDistanceMatrix(ostream& os, int rows, int cols, const vector<double>& out) {
+    if ((size_t)rows * (size_t)cols != out.size()) return false;
+    os.write("DISTMAT1", 8);
+    os.write((const char*)&rows, sizeof(rows));
+    os.write((const char*)&cols, sizeof(cols));
+    if (!out.empty()) os.write((const char*)&out[0], (streamsize)(out.size() * sizeof(double)));
+    return (bool)os;
+}
+
+bool readDistanceMatrix(istream& is, int& rows, int& cols, vector<double>& out) {
+    char magic[8];
+    if (!is.read(magic, 8) || memcmp(magic, "DISTMAT1", 8) != 0) return false;
+    if (!is.read((char*)&rows, sizeof(rows)) || !is.read((char*)&cols, sizeof(cols))) return false;
+    if (rows < 0 || cols < 0) return false;
+    out.resize((size_t)rows * (size_t)cols);
+    if (!out.empty() && !is.read((char*)&out[0], (streamsize)(out.size() * sizeof(double)))) return false;
+    return true;
+}
+
+// 单源全图最短路（无终点提前停止），用于计算地标距离表
+static void fullDijkstra(const CsrGraph& g, const vector<double>& w, int src, vector<double>& dist) {
+    dist.assign(g.n + 1, INF);
+    priority_queue<NodeDist, vector<NodeDist>, NodeDistGreater> pq;
+    dist[src] = 0.0;
+    pq.push(NodeDist(src, 0.0));
+    while (!pq.empty()) {
+        NodeDist cur = pq.top();
+        pq.pop();
+        int u = cur.node;
+        if (cur.dist != dist[u]) continue;
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = cur.dist + w[i];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                pq.push(NodeDist(v, nd));
+            }
+        }
+    }
+}
+
+// 地标选择：首个地标取 1 号节点的最远点，之后每次取到已选地标最小距离最大的节点（不可达视为无穷远，可覆盖其他连通分量）
+void buildAltLandmarks(const CsrGraph& g, const vector<double>& w, int k, AltLandmarks& alt) {
+    int n = g.n;
+    if (k > n) k = n;
+    alt.k = k;
+    alt.landmarks.clear();
+    alt.table.assign((size_t)(n + 1) * (size_t)k, INF);
+    if (k <= 0) return;
+
+    vector<double> dist;
+    vector<double> minDist(n + 1, INF);
+    fullDijkstra(g, w, 1, dist);
+    int next = 1;
+    for (int v = 1; v <= n; ++v) {
+        if (dist[v] != INF && dist[v] > dist[next]) next = v;
+    }
+    for (int i = 0; i < k; ++i) {
+        alt.landmarks.push_back(next);
+        fullDijkstra(g, w, next, dist);
+        for (int v = 1; v <= n; ++v) {
+            alt.table[(size_t)v * k + i] = dist[v];
+            if (dist[v] < minDist[v]) minDist[v] = dist[v];
+        }
+        int far = -1;
+        for (int v = 1; v <= n; ++v) {
+            if (minDist[v] == 0.0) continue;
+            if (far == -1 || minDist[v] > minDist[far]) far = v;
+        }
+        if (far == -1) {
+            alt.k = i + 1;
+            break;
+        }
+        next = far;
+    }
+    // 地标数不足时压缩表的列
+    if (alt.k != k) {
+        vector<double> packed((size_t)(n + 1) * alt.k, INF);
+        for (int v = 1; v <= n; ++v) {
+            for (int i = 0; i < alt.k; ++i) packed[(size_t)v * alt.k + i] = alt.table[(size_t)v * k + i];
+        }
+        alt.table.swap(packed);
+    }
+}
+
+double altLowerBound(const AltLandmarks& alt, int v, int t) {
+    const double* dv = &alt.table[(size_t)v * alt.k];
+    const double* dt = &alt.table[(size_t)t * alt.k];
+    double h = 0.0;
+    for (int i = 0; i < alt.k; ++i) {
+        if (dv[i] == INF || dt[i] == INF) continue;
+        double diff = dt[i] - dv[i];
+        if (diff < 0) diff = -diff;
+        if (diff > h) h = diff;
+    }
+    return h;
+}
+
+// ALT 查询：优先队列按 dist + h 排序，终点出堆即停止
+bool altSearch(const CsrGraph& g, const vector<double>& w, const AltLandmarks& alt, int s, int t, vector<int>& prevNode, vector<double>& dist, long long* settled) {
+    int n = g.n;
+    dist.assign(n + 1, INF);
+    prevNode.assign(n + 1, -1);
+    vector<char> used(n + 1, 0);
+    priority_queue<NodeDist, vector<NodeDist>, NodeDistGreater> pq;
+    if (settled) *settled = 0;
+
+    dist[s] = 0.0;
+    pq.push(NodeDist(s, altLowerBound(alt, s, t)));
+    while (!pq.empty()) {
+        NodeDist cur = pq.top();
+        pq.pop();
+        int u = cur.node;
+        if (used[u]) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        used[u] = 1;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        if (u == t) break;
+
+        double du = dist[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + w[i];
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
+                pq.push(NodeDist(v, nd + altLowerBound(alt, v, t)));
+            }
+        }
+    }
+    return dist[t] != INF;
+}
+
 // 路径还原
 vector<int> buildPath(int s, int t, const vector<int>& prevNode) {
     vector<int> path;
@@ -88,6 +403,25 @@ vector<int> buildPath(int s, int t, const vector<int>& prevNode) {
     return path;
 }
 
+// 路径还原（CSR 图版本）
+vector<int> buildPath(const CsrGraph& g, int s, int t, const vector<int>& prevNode) {
+    if (s < 1 || s > g.n || t < 1 || t > g.n || (int)prevNode.size() < g.n + 1) return vector<int>();
+    return buildPath(s, t, prevNode);
+}
+
+// 路径还原（工作区版本）
+vector<int> buildPath(const DijkstraWorkspace& ws, int s, int t) {
+    vector<int> path;
+    if (t < 0 || t >= (int)ws.stamp.size() || ws.stamp[t] != ws.epoch) return path;
+    for (int cur = t; cur != -1; cur = ws.prevOf(cur)) {
+        path.push_back(cur);
+        if (cur == s) break;
+    }
+    if (path.back() != s) return vector<int>();
+    reverse(path.begin(), path.end());
+    return path;
+}
+
 // 打印路径
 void printPath(const vector<int>& path) {
     for (size_t i = 0; i < path.size(); ++i) {
@@ -1,6 +1,14 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 #include <vector>
+#include <ostream>
+#include <queue>
+#include <limits>
+#include <algorithm>
+#include "../common/perf_stats.h"
+
+// 默认红绿灯等待时间（秒/灯）
+const double DEFAULT_LIGHT_WAIT_SECONDS = 30.0;
 
 struct Edge {
     int to;    // to：目标节点编号
@@ -11,6 +19,105 @@ struct Edge {
     Edge(int t, double len, double cong, int l);
 };
 
+// 输入的一条双向道路（u-v），用于一次性构建 CSR 图
+struct Road {
+    int u;    // u、v：道路两端节点编号
+    int v;
+    double length;    // length：道路长度
+    double congestion;    // congestion：拥堵系数（>=1）
+    int lights;    // lights：红绿灯数量
+    Road();
+    Road(int a, int b, double len, double cong, int l);
+};
+
+// CSR 图的数组：默认持有自己的 std::vector 存储；也可借用外部只读内存（如 mmap 映射的快照文件）
+// 借用时不复制数据，借用的内存须比数组活得久
+template <class T>
+struct CsrArray {
+    std::vector<T> store;    // store：自有存储（借用时为空）
+    T* ptr;    // ptr：指向 store 或外部内存
+    size_t len;
+    CsrArray() : ptr(0), len(0) {}
+    CsrArray(const CsrArray& o) : store(o.store), ptr(o.ptr), len(o.len) {
+        if (!o.borrowed()) ptr = store.empty() ? 0 : &store[0];
+    }
+    CsrArray& operator=(const CsrArray& o) {
+        if (this != &o) {
+            store = o.store;
+            len = o.len;
+            ptr = o.borrowed() ? o.ptr : (store.empty() ? 0 : &store[0]);
+        }
+        return *this;
+    }
+    void assign(size_t n, const T& v) {
+        store.assign(n, v);
+        ptr = store.empty() ? 0 : &store[0];
+        len = n;
+    }
+    void borrow(const T* p, size_t n) {
+        std::vector<T>().swap(store);
+        ptr = const_cast<T*>(p);
+        len = n;
+    }
+    bool borrowed() const { return len > 0 && (store.empty() || ptr != &store[0]); }
+    size_t size() const { return len; }
+    bool empty() const { return len == 0; }
+    T* data() { return ptr; }
+    const T* data() const { return ptr; }
+    T* begin() { return ptr; }
+    T* end() { return ptr + len; }
+    const T* begin() const { return ptr; }
+    const T* end() const { return ptr + len; }
+    T& operator[](size_t i) { return ptr[i]; }
+    const T& operator[](size_t i) const { return ptr[i]; }
+};
+
+// CSR（压缩稀疏行）图：构建后只读
+// 节点 u 的出边位于下标区间 [offset[u], offset[u+1])，边属性按字段分开存放（结构数组）
+// 这样按长度查询时只触及 to/length 两个数组，松弛循环的缓存利用率更高
+struct CsrGraph {
+    int n;    // n：节点数（1..N）
+    int m;    // m：有向边数（每条道路两个方向各一条）
+    CsrArray<int> offset;    // offset：大小 n+2
+    CsrArray<int> to;    // to：目标节点编号
+    CsrArray<double> length;    // length：道路长度
+    CsrArray<double> congestion;    // congestion：拥堵系数
+    CsrArray<int> lights;    // lights：红绿灯数量
+    CsrArray<int> roadSlot;    // roadSlot[2r]/[2r+1]：第 r 条输入道路 u->v / v->u 方向的边下标（非法道路为 -1）
+    CsrGraph();
+};
+
+// 代价策略：给定 CSR 图与边下标，返回该边的非负代价
+// 内置策略：LengthCost（仅长度）、TravelTimeCost（长度*拥堵+红绿灯等待）
+// PrecomputedCost 包装一段预先算好的扁平边权数组；也可传入任意自定义函数对象
+
+// 仅道路长度
+struct LengthCost {
+    double operator()(const CsrGraph& g, int i) const { return g.length[i]; }
+};
+
+// 加权通行时间：长度*拥堵 + 红绿灯数量*等待时间（等待时间为策略参数）
+struct TravelTimeCost {
+    double lightWait;    // lightWait：每个红绿灯的等待秒数
+    explicit TravelTimeCost(double wait = DEFAULT_LIGHT_WAIT_SECONDS) : lightWait(wait) {}
+    double operator()(const CsrGraph& g, int i) const {
+        return g.length[i] * g.congestion[i] + (double)g.lights[i] * lightWait;
+    }
+};
+
+// 预计算边权：内层循环只剩“读取-相加-比较”
+struct PrecomputedCost {
+    const double* w;    // w：按 CSR 边下标排列的边权，长度为 g.m
+    explicit PrecomputedCost(const std::vector<double>& weights) : w(weights.empty() ? 0 : &weights[0]) {}
+    explicit PrecomputedCost(const double* weights) : w(weights) {}    // 借用已有数组（如快照映射的 g.length），不复制
+    double operator()(const CsrGraph&, int i) const { return w[i]; }
+};
+
+// 由道路列表构建 CSR 图（计数排序，两遍扫描，无逐节点分配）
+// 非法端点的道路被忽略；拥堵系数小于 1 按 1 处理
+// 同一节点的出边顺序与邻接表版本 push_back 的顺序一致
+void buildCsrGraph(int n, const std::vector<Road>& roads, CsrGraph& g);
+
 // Dijkstra 最短路
 // 参数：
 // g：邻接表图（1..N）
@@ -22,10 +129,260 @@ struct Edge {
 // dist：到各点的最短代价
 bool dijkstra(const std::vector< std::vector<Edge> >& g, int s, int t, int mode, std::vector<int>& prevNode, std::vector<double>& dist);
 
+// Dijkstra 最短路（CSR 图版本），参数与输出约定同上
+// mode 只在入口处分派一次，内部调用对应代价策略的模板版本
+bool dijkstra(const CsrGraph& g, int s, int t, int mode, std::vector<int>& prevNode, std::vector<double>& dist);
+
+// 按代价策略把每条边的代价预计算到扁平数组 w（长度 g.m）
+template <class Cost>
+void precomputeWeights(const CsrGraph& g, const Cost& cost, std::vector<double>& w);
+
+// Dijkstra 最短路（代价策略模板版本），cost 在编译期确定，循环内无模式分支
+// settled：非空时写入本次确定（出堆）的节点数
+template <class Cost>
+bool dijkstra(const CsrGraph& g, const Cost& cost, int s, int t, std::vector<int>& prevNode, std::vector<double>& dist, long long* settled = 0);
+
+// Dijkstra 用的节点-距离结构（用于优先队列）
+struct NodeDist {
+    int node;
+    double dist;
+    NodeDist() : node(0), dist(0) {}
+    NodeDist(int n, double d) : node(n), dist(d) {}
+};
+
+// 小根堆比较器
+struct NodeDistGreater {
+    bool operator()(const NodeDist& a, const NodeDist& b) const {
+        return a.dist > b.dist;
+    }
+};
+
+// Dijkstra 查询工作区：持有 dist/prevNode/堆缓冲并在多次查询间复用
+// 用时间戳（epoch）惰性复位：stamp[v] != epoch 的节点视为未访问，每次查询只需 epoch+1，
+// 代价只与本次访问的节点数有关，重复查询不再分配内存
+struct DijkstraWorkspace {
+    std::vector<double> dist;
+    std::vector<int> prevNode;
+    std::vector<unsigned> stamp;    // stamp[v] == epoch：本次查询已写入 dist/prevNode
+    std::vector<unsigned> doneStamp;    // doneStamp[v] == epoch：本次查询已确定
+    std::vector<unsigned> targetStamp;    // targetStamp[v] == epoch：v 是本次多终点查询的终点
+    std::vector<NodeDist> heap;
+    unsigned epoch;
+    DijkstraWorkspace();
+    // 开始一次新查询（节点 1..n）：必要时扩容，epoch 回绕时整体清零
+    void begin(int n);
+    double distOf(int v) const;    // 未访问返回无穷大
+    int prevOf(int v) const;    // 未访问返回 -1
+};
+
+// Dijkstra 最短路（工作区版本）：结果通过 ws.distOf/ws.prevOf 读取
+template <class Cost>
+bool dijkstra(const CsrGraph& g, const Cost& cost, int s, int t, DijkstraWorkspace& ws, long long* settled = 0);
+
+// 单源多终点 Dijkstra：targets 中的节点全部确定后即停止，返回到达的不同终点数
+template <class Cost>
+int dijkstraToTargets(const CsrGraph& g, const Cost& cost, int s, const std::vector<int>& targets, DijkstraWorkspace& ws, long long* settled = 0);
+
+// 多对多距离矩阵：out 为按行主序的 |sources|*|targets| 连续缓冲，
+// out[i*|targets| + j] 为 sources[i] -> targets[j] 的最短代价（不可达或编号无效为无穷大）
+// 每个起点做一次多终点提前停止的搜索，各行由 threads 个线程并行计算
+// w：按 CSR 边下标排列的边权
+void distanceMatrix(const CsrGraph& g, const std::vector<double>& w, const std::vector<int>& sources, const std::vector<int>& targets, std::vector<double>& out, int threads = 1);
+
+// 同上，按 mode 选择代价（0=仅长度；1=长度*拥堵+红绿灯等待，使用默认等待时间）
+void distanceMatrix(const CsrGraph& g, const std::vector<int>& sources, const std::vector<int>& targets, int mode, std::vector<double>& out, int threads = 1);
+
+// 以二进制写出距离矩阵：8 字节魔数 "DISTMAT1"、int32 行数、int32 列数，随后为行主序的 double 数据
+bool writeDistanceMatrix(std::ostream& os, int rows, int cols, const std::vector<double>& out);
+
+// 读回 writeDistanceMatrix 写出的矩阵；魔数不符、行列数为负或数据不完整时返回 false
+bool readDistanceMatrix(std::istream& is, int& rows, int& cols, std::vector<double>& out);
+
+// 双向 Dijkstra：从 s 正向、从 t 反向交替推进，两侧堆顶之和不小于当前最优值时停止
+// w：按 CSR 边下标排列的边权；输出约定同 dijkstra（dist[t] 为最短代价，prevNode 可直接还原 s->t 路径）
+bool bidirectionalDijkstra(const CsrGraph& g, const std::vector<double>& w, int s, int t, std::vector<int>& prevNode, std::vector<double>& dist, long long* settled = 0);
+
+// ALT 地标表：landmarks 为地标节点，table[v*k + i] 为第 i 个地标到 v 的最短代价（节点为主序，查询时连续访问）
+struct AltLandmarks {
+    int k;    // k：地标数量
+    std::vector<int> landmarks;
+    std::vector<double> table;
+    AltLandmarks();
+};
+
+// 选择 k 个地标（最远点策略：每次取离已选地标最远的节点）并计算距离表
+void buildAltLandmarks(const CsrGraph& g, const std::vector<double>& w, int k, AltLandmarks& alt);
+
+// 三角不等式下界：v 到 t 的代价不小于 max_i |d(L_i,t) - d(L_i,v)|（跳过不可达的地标）
+double altLowerBound(const AltLandmarks& alt, int v, int t);
+
+// ALT 查询：A* 搜索，启发值为各地标三角不等式下界 |d(L,t) - d(L,v)| 的最大值
+// 输出约定同 dijkstra
+bool altSearch(const CsrGraph& g, const std::vector<double>& w, const AltLandmarks& alt, int s, int t, std::vector<int>& prevNode, std::vector<double>& dist, long long* settled = 0);
+
 // 根据前驱数组还原 s->t 的路径节点序列
 std::vector<int> buildPath(int s, int t, const std::vector<int>& prevNode);
 
+// 根据前驱数组还原 s->t 的路径（CSR 图版本，额外校验节点编号范围）
+std::vector<int> buildPath(const CsrGraph& g, int s, int t, const std::vector<int>& prevNode);
+
+// 根据工作区中的前驱还原 s->t 的路径
+std::vector<int> buildPath(const DijkstraWorkspace& ws, int s, int t);
+
 // 打印路径节点序列
 void printPath(const std::vector<int>& path);
 
+// ---------------- 模板实现 ----------------
+
+template <class Cost>
+void precomputeWeights(const CsrGraph& g, const Cost& cost, std::vector<double>& w) {
+    w.resize(g.m);
+    for (int i = 0; i < g.m; ++i) w[i] = cost(g, i);
+}
+
+template <class Cost>
+bool dijkstra(const CsrGraph& g, const Cost& cost, int s, int t, std::vector<int>& prevNode, std::vector<double>& dist, long long* settled) {
+    int n = g.n;
+    dist.assign(n + 1, std::numeric_limits<double>::infinity());
+    prevNode.assign(n + 1, -1);
+
+    std::priority_queue<NodeDist, std::vector<NodeDist>, NodeDistGreater> pq;
+    dist[s] = 0.0;
+    pq.push(NodeDist(s, 0.0));
+
+    std::vector<char> used(n + 1, 0);
+    if (settled) *settled = 0;
+
+    while (!pq.empty()) {
+        NodeDist cur = pq.top();
+        pq.pop();
+        int u = cur.node;
+        if (used[u]) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        used[u] = 1;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        if (u == t) break;
+
+        double du = dist[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + cost(g, i);
+            if (nd < dist[v]) {
+                dist[v] = nd;
+                prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
+                pq.push(NodeDist(v, nd));
+            }
+        }
+    }
+
+    return dist[t] != std::numeric_limits<double>::infinity();
+}
+
+template <class Cost>
+bool dijkstra(const CsrGraph& g, const Cost& cost, int s, int t, DijkstraWorkspace& ws, long long* settled) {
+    ws.begin(g.n);
+    const unsigned ep = ws.epoch;
+    std::vector<NodeDist>& heap = ws.heap;
+    NodeDistGreater cmp;
+    if (settled) *settled = 0;
+
+    ws.dist[s] = 0.0;
+    ws.prevNode[s] = -1;
+    ws.stamp[s] = ep;
+    heap.push_back(NodeDist(s, 0.0));
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        NodeDist cur = heap.back();
+        heap.pop_back();
+        int u = cur.node;
+        if (ws.doneStamp[u] == ep) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        ws.doneStamp[u] = ep;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        if (u == t) break;
+
+        double du = ws.dist[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + cost(g, i);
+            if (ws.stamp[v] != ep || nd < ws.dist[v]) {
+                ws.stamp[v] = ep;
+                ws.dist[v] = nd;
+                ws.prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
+                heap.push_back(NodeDist(v, nd));
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+
+    return ws.stamp[t] == ep;
+}
+
+template <class Cost>
+int dijkstraToTargets(const CsrGraph& g, const Cost& cost, int s, const std::vector<int>& targets, DijkstraWorkspace& ws, long long* settled) {
+    ws.begin(g.n);
+    const unsigned ep = ws.epoch;
+    std::vector<NodeDist>& heap = ws.heap;
+    NodeDistGreater cmp;
+    if (settled) *settled = 0;
+
+    int remaining = 0;
+    for (size_t i = 0; i < targets.size(); ++i) {
+        if (ws.targetStamp[targets[i]] == ep) continue;
+        ws.targetStamp[targets[i]] = ep;
+        ++remaining;
+    }
+    int reached = 0;
+
+    ws.dist[s] = 0.0;
+    ws.prevNode[s] = -1;
+    ws.stamp[s] = ep;
+    heap.push_back(NodeDist(s, 0.0));
+
+    while (!heap.empty() && remaining > 0) {
+        std::pop_heap(heap.begin(), heap.end(), cmp);
+        NodeDist cur = heap.back();
+        heap.pop_back();
+        int u = cur.node;
+        if (ws.doneStamp[u] == ep) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        ws.doneStamp[u] = ep;
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        if (ws.targetStamp[u] == ep) {
+            ++reached;
+            if (--remaining == 0) break;
+        }
+
+        double du = ws.dist[u];
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nd = du + cost(g, i);
+            if (ws.stamp[v] != ep || nd < ws.dist[v]) {
+                ws.stamp[v] = ep;
+                ws.dist[v] = nd;
+                ws.prevNode[v] = u;
+                PERF_INC(PERF_PUSHES);
+                heap.push_back(NodeDist(v, nd));
+                std::push_heap(heap.begin(), heap.end(), cmp);
+            }
+        }
+    }
+    return reached;
+}
+
 #endif
@@ -3,78 +3,511 @@
 #include <string>
 #include <iomanip>
 #include <ctime>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <fstream>
 #include "graph.h"
+#include "ch.h"
+#include "frontier.h"
+#include "batch.h"
+#include "../common/parallel.h"
+#include "dynamic.h"
+#include "snapshot.h"
+#include "delta.h"
+#include "reorder.h"
+#include "pareto.h"
+#include "../common/fast_input.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
 using namespace std;
 
-int main() {
+// 输出一条查询结果（mode=0 按长度，mode=1 按加权通行时间）
+static void printAnswer(int mode, double best, const vector<int>& path, double ms) {
+    cout << fixed << setprecision(3);
+    if (mode == 0) cout << "最短距离: " << best << "\n";
+    else cout << "最短加权通行时间: " << best << "\n";
+    cout << "路径: ";
+    printPath(path);
+    cout << "耗时(毫秒): " << ms << "\n";
+}
+
+int main(int argc, char** argv) {
+    // 命令行参数：
+    // --light-wait 秒数：每个红绿灯的等待时间（默认 30）
+    // --ch：预处理收缩层次后用 CH 回答查询
+    // --ch-save 前缀 / --ch-load 前缀：保存 / 加载两种模式的收缩层次（前缀.mode0.ch、前缀.mode1.ch）
+    // --algo dijkstra|bidir|alt：查询算法（默认单向 Dijkstra）；--landmarks k：ALT 地标数（默认 8）
+    // --frontier binary|quad|radix：单向 Dijkstra 的优先队列；--radix-scale u：基数堆的整数化精度（默认 1000）
+    // --algo delta：并行 delta-stepping 求一对全部再取路径（线程数同 --threads）；--delta 宽度：桶宽（默认平均边权）
+    double lightWait = DEFAULT_LIGHT_WAIT_SECONDS;
+    string algo = "dijkstra";
+    int landmarkCount = 8;
+    string frontier = "binary";
+    double radixScale = 1000.0;
+    double delta = 0.0;
+    // --batch：先读入全部查询，按（起点, 模式）分组并行求解；--threads k：线程数（默认硬件并发数）
+    bool batch = false;
+    int threads = defaultThreadCount();
+    // --pack 文件：读入文本图后写出二进制快照；--graph 文件：映射快照代替文本图（标准输入只含查询部分）
+    const char* packFile = 0;
+    const char* graphFile = 0;
+    // --reorder：加载后按 RCM 序重编号节点以改善缓存局部性，查询与输出仍使用原编号
+    bool reorder = false;
+    // --pareto-labels k：type=4 Pareto 查询中每个节点保留的标签上限（默认 4）
+    int paretoLabels = 4;
+    // --stats：每次查询后向标准错误输出一行 JSON 统计（计数需以 -DPERF_STATS 编译；批量模式不输出）
+    bool stats = false;
+    // --depots 列表：逗号分隔的固定起点（如车场），加载时按加权通行时间各建一棵最短路树，
+    // type=3 更新道路后增量修复（--threads 个线程），type=5 直接查树
+    const char* depotList = 0;
+    // --matrix 文件：多对多距离矩阵模式，图之后的输入为 “mode R 起点1..起点R C 终点1..终点C”，
+    // 各行由 --threads 个线程并行计算，以 DISTMAT1 二进制格式写到文件
+    const char* matrixFile = 0;
+    bool useCh = false;
+    const char* chSave = 0;
+    const char* chLoad = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--light-wait") == 0 && i + 1 < argc) lightWait = atof(argv[++i]);
+        else if (strcmp(argv[i], "--algo") == 0 && i + 1 < argc) algo = argv[++i];
+        else if (strcmp(argv[i], "--landmarks") == 0 && i + 1 < argc) landmarkCount = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--frontier") == 0 && i + 1 < argc) frontier = argv[++i];
+        else if (strcmp(argv[i], "--radix-scale") == 0 && i + 1 < argc) radixScale = atof(argv[++i]);
+        else if (strcmp(argv[i], "--delta") == 0 && i + 1 < argc) delta = atof(argv[++i]);
+        else if (strcmp(argv[i], "--pack") == 0 && i + 1 < argc) packFile = argv[++i];
+        else if (strcmp(argv[i], "--graph") == 0 && i + 1 < argc) graphFile = argv[++i];
+        else if (strcmp(argv[i], "--batch") == 0) batch = true;
+        else if (strcmp(argv[i], "--reorder") == 0) reorder = true;
+        else if (strcmp(argv[i], "--pareto-labels") == 0 && i + 1 < argc) paretoLabels = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--stats") == 0) stats = true;
+        else if (strcmp(argv[i], "--depots") == 0 && i + 1 < argc) depotList = argv[++i];
+        else if (strcmp(argv[i], "--matrix") == 0 && i + 1 < argc) matrixFile = argv[++i];
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--ch") == 0) useCh = true;
+        else if (strcmp(argv[i], "--ch-save") == 0 && i + 1 < argc) { chSave = argv[++i]; useCh = true; }
+        else if (strcmp(argv[i], "--ch-load") == 0 && i + 1 < argc) { chLoad = argv[++i]; useCh = true; }
+    }
+
+    // 批量模式按（起点, 模式）分组，每组一次多终点 Dijkstra（二叉堆），与 --ch / --algo / --frontier 选择的求解器无关；
+    // 直接拒绝这些组合，以免把批量结果当作所选求解器的结果，也省去用不到的预处理
+    if (batch && (useCh || algo != "dijkstra" || frontier != "binary")) {
+        cout << "--batch 只使用分组的单向 Dijkstra，不能与 --ch、--algo、--frontier 同时使用\n";
+        return 1;
+    }
+
+    // --delta 为 0 表示取默认桶宽；负数、NaN 与无穷大没有意义
+    if (!(delta >= 0.0) || std::isinf(delta)) {
+        cout << "--delta 应为非负的有限数\n";
+        return 1;
+    }
+
     ios::sync_with_stdio(false);
-    cin.tie(0);
     #ifdef _WIN32
     SetConsoleOutputCP(65001);
     #endif
 
-    // 读取城市图基础信息：节点数 N、道路数 M
-    int N, M;
-    if (!(cin >> N >> M)) {
-        cout << "输入格式:\n";
-        cout << "N M\n";
-        cout << "接下来 M 行: u v 长度 拥堵系数 红绿灯数量\n";
-        cout << "Q\n";
-        cout << "接下来 Q 行: type s t   (type=1 按长度最短路径, type=2 按加权通行时间)\n";
+    // 输入统一经 FastInput 读取：重定向自文件时整体映射，否则按块读入
+    FastInput in;
+    in.openStdin();
+
+    // 图来源：映射二进制快照，或读取文本“N M + M 行道路”后构建 CSR
+    CsrGraph g;
+    MappedFile snapshot;
+    int N;
+    if (graphFile) {
+        if (!mapGraphSnapshot(graphFile, snapshot, g)) {
+            cout << "快照文件无效: " << graphFile << "\n";
+            return 0;
+        }
+        N = g.n;
+    } else {
+        // 读取城市图基础信息：节点数 N、道路数 M
+        int M;
+        if (!in.readInt(N) || !in.readInt(M)) {
+            cout << "输入格式:\n";
+            cout << "N M\n";
+            cout << "接下来 M 行: u v 长度 拥堵系数 红绿灯数量\n";
+            cout << "Q\n";
+            cout << "接下来 Q 行: type s t   (type=1 按长度最短路径, type=2 按加权通行时间)\n";
+            cout << "          或: 3 道路序号 拥堵系数 红绿灯数量   (在线更新第几条道路, 从 1 开始)\n";
+            cout << "          或: 4 s t   (一次搜索给出长度与加权通行时间的 Pareto 路线)\n";
+            cout << "          或: 5 s t   (s 为 --depots 中的固定起点, 查其最短路树得到加权通行时间与路径)\n";
+            cout << "可选参数: --light-wait 秒数 (红绿灯等待时间, 默认 30)\n";
+            cout << "          --ch | --ch-save 前缀 | --ch-load 前缀 (收缩层次预处理/保存/加载)\n";
+            cout << "          --algo dijkstra|bidir|alt|delta (查询算法), --landmarks k (ALT 地标数, 默认 8)\n";
+            cout << "          --delta 宽度 (delta-stepping 桶宽, 默认平均边权)\n";
+            cout << "          --frontier binary|quad|radix (优先队列), --radix-scale u (基数堆整数化精度, 默认 1000)\n";
+            cout << "          --batch (按起点分组批量并行求解, 不能与 --ch/--algo/--frontier 同用), --threads k (线程数)\n";
+            cout << "          --pack 文件 (写出二进制图快照), --graph 文件 (映射快照, 标准输入只含 Q 与查询)\n";
+            cout << "          --reorder (按 RCM 序重编号节点, 输入输出编号不变)\n";
+            cout << "          --pareto-labels k (Pareto 查询每个节点的标签上限, 默认 4)\n";
+            cout << "          --stats (每次查询向标准错误输出 JSON 统计, 计数需 -DPERF_STATS 编译; bidir/alt 另与单向 Dijkstra 对比确定节点数)\n";
+            cout << "          --depots s1,s2,... (固定起点, 维护加权通行时间最短路树并随 type=3 更新增量修复)\n";
+            cout << "          --matrix 文件 (距离矩阵模式: 图之后输入 mode R 起点1..起点R C 终点1..终点C, 写出 DISTMAT1 二进制矩阵)\n";
+            return 0;
+        }
+
+        // 读取道路列表，一次性构建无向图（CSR）
+        vector<Road> roads;
+        roads.reserve(M);
+        for (int i = 0; i < M; ++i) {
+            int u = 0, v = 0, lights = 0;
+            double len = 0.0, cong = 0.0;
+            in.readInt(u);
+            in.readInt(v);
+            in.readDouble(len);
+            in.readDouble(cong);
+            in.readInt(lights);
+            roads.push_back(Road(u, v, len, cong, lights));
+        }
+        buildCsrGraph(N, roads, g);
+        vector<Road>().swap(roads);
+
+        if (packFile) {
+            if (writeGraphSnapshot(g, packFile)) cout << "图快照已写出: " << packFile << "\n";
+            else cout << "图快照写出失败: " << packFile << "\n";
+        }
+    }
+
+    // 节点重编号：快照按原编号写出；收缩层次文件与是否重编号绑定，保存与加载时需使用相同设置
+    NodeOrder order;
+    if (reorder) {
+        CsrGraph permuted;
+        computeRcmOrder(g, order);
+        permuteCsrGraph(g, order, permuted);
+        g = permuted;
+    }
+
+    // 扁平边权：加权通行时间依赖 --light-wait，加载时预计算一次；长度边权就是 g.length，
+    // 单向 Dijkstra 与批量查询通过 PrecomputedCost 直接读取（快照映射时即读映射内存，启动时不复制）
+    // 其他算法的接口需要 vector：文本图直接用 g.length 自有的存储，快照图在首次用到时才复制一份
+    vector<double> lengthCopy, timeWeights;
+    precomputeWeights(g, TravelTimeCost(lightWait), timeWeights);
+    PrecomputedCost costOf[2] = { PrecomputedCost(g.length.data()), PrecomputedCost(timeWeights) };
+    auto weightsOf = [&](int mode) -> const vector<double>& {
+        if (mode == 1) return timeWeights;
+        if (!g.length.borrowed()) return g.length.store;
+        if (lengthCopy.size() != g.length.size()) lengthCopy.assign(g.length.begin(), g.length.end());
+        return lengthCopy;
+    };
+
+    // 距离矩阵模式：只做一次多对多计算，不再读查询；矩阵与节点编号无关，重编号时只需换算起终点
+    if (matrixFile) {
+        int mode = 0, R = 0, C = 0;
+        in.readInt(mode);
+        in.readInt(R);
+        vector<int> sources(R > 0 ? R : 0);
+        for (int i = 0; i < R; ++i) in.readInt(sources[i]);
+        in.readInt(C);
+        vector<int> targets(C > 0 ? C : 0);
+        for (int j = 0; j < C; ++j) in.readInt(targets[j]);
+        if (reorder) {
+            for (size_t i = 0; i < sources.size(); ++i) if (sources[i] >= 1 && sources[i] <= N) sources[i] = order.newOf[sources[i]];
+            for (size_t j = 0; j < targets.size(); ++j) if (targets[j] >= 1 && targets[j] <= N) targets[j] = order.newOf[targets[j]];
+        }
+        vector<double> matrix;
+        PerfTimer timer;
+        distanceMatrix(g, weightsOf(mode == 1 ? 1 : 0), sources, targets, matrix, threads);
+        double ms = timer.elapsedMs();
+        ofstream os(matrixFile, ios::binary);
+        if (!writeDistanceMatrix(os, (int)sources.size(), (int)targets.size(), matrix)) {
+            cout << "距离矩阵写出失败: " << matrixFile << "\n";
+            return 0;
+        }
+        cout << "距离矩阵 " << sources.size() << "x" << targets.size() << " 已写出: " << matrixFile
+             << ", 计算耗时(毫秒): " << ms << "\n";
         return 0;
     }
 
-    // 构建无向图（邻接表）
-    vector< vector<Edge> > g(N + 1);
-    for (int i = 0; i < M; ++i) {
-        int u, v, lights;
-        double len, cong;
-        cin >> u >> v >> len >> cong >> lights;
-        if (u < 1 || u > N || v < 1 || v > N) continue;
-        if (cong < 1.0) cong = 1.0;
-        g[u].push_back(Edge(v, len, cong, lights));
-        g[v].push_back(Edge(u, len, cong, lights));
+    // delta-stepping：桶宽小于最小正边权时只会增加空桶（桶数约为最大距离/桶宽），按两种模式的最小正边权截断；
+    // 线程池在整个运行中共用，每次查询不再创建与回收线程
+    if (algo == "delta" && delta > 0.0) {
+        double minW = numeric_limits<double>::infinity();
+        for (int mode = 0; mode < 2; ++mode) {
+            const vector<double>& w = weightsOf(mode);
+            for (size_t i = 0; i < w.size(); ++i) {
+                if (w[i] > 0.0 && w[i] < minW) minW = w[i];
+            }
+        }
+        if (delta < minW && minW != numeric_limits<double>::infinity()) {
+            cout << "--delta " << delta << " 小于最小正边权, 按 " << minW << " 计算\n";
+            delta = minW;
+        }
+    }
+    PhasePool deltaPool(algo == "delta" ? threads : 1);
+
+    // 基数堆需要整数边权：按 radixScale 缩放取整，结果再除回
+    vector<double> radixWeights[2];
+    if (frontier == "radix") {
+        for (int mode = 0; mode < 2; ++mode) quantizeWeights(weightsOf(mode), radixScale, radixWeights[mode]);
     }
 
+    // ALT 地标距离表：每种模式一份，加载时计算；其他算法下在首次 Pareto 查询时计算，在线更新后作废
+    AltLandmarks alt[2];
+    bool altReady = false;
+    if (algo == "alt") {
+        for (int mode = 0; mode < 2; ++mode) buildAltLandmarks(g, weightsOf(mode), landmarkCount, alt[mode]);
+        altReady = true;
+    }
+
+    // 收缩层次：每种模式一份，优先从文件加载，否则现场预处理
+    ContractionHierarchy ch[2];
+    ChQueryWorkspace chWs[2];
+    if (useCh) {
+        for (int mode = 0; mode < 2; ++mode) {
+            string file;
+            if (chLoad) {
+                file = string(chLoad) + (mode == 0 ? ".mode0.ch" : ".mode1.ch");
+                if (!loadContractionHierarchy(ch[mode], file.c_str()) || ch[mode].n != g.n || ch[mode].m != g.m) {
+                    cout << "收缩层次文件无效，重新预处理: " << file << "\n";
+                } else if (ch[mode].reordered != reorder || (mode == 1 && ch[mode].lightWait != lightWait)
+                           || ch[mode].weightChecksum != weightChecksum(weightsOf(mode))) {
+                    // 文件对应的节点编号或边权与本次运行不同，沿用会得到错误的路径
+                    cout << "收缩层次文件与当前设置不符 (--light-wait / --reorder / 道路数据)，重新预处理: " << file << "\n";
+                } else {
+                    continue;
+                }
+            }
+            clock_t st = clock();
+            buildContractionHierarchy(g, weightsOf(mode), ch[mode]);
+            ch[mode].lightWait = lightWait;
+            ch[mode].reordered = reorder;
+            clock_t ed = clock();
+            cout << "收缩层次预处理(mode=" << mode << ") 耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
+            if (chSave) {
+                file = string(chSave) + (mode == 0 ? ".mode0.ch" : ".mode1.ch");
+                if (!saveContractionHierarchy(ch[mode], file.c_str())) cout << "收缩层次保存失败: " << file << "\n";
+            }
+        }
+    }
+
+    // 固定起点最短路树（加权通行时间，内部编号）：depotIndex[v] 为以 v 为起点的树在 depotTrees 中的下标，非固定起点为 -1
+    vector<ShortestPathTree> depotTrees;
+    vector<int> depotIndex;
+    if (depotList) {
+        depotIndex.assign(N + 1, -1);
+        const char* p = depotList;
+        while (*p) {
+            char* endp = 0;
+            long v = strtol(p, &endp, 10);
+            if (endp == p) break;
+            if (v >= 1 && v <= N) {
+                int x = reorder ? order.newOf[v] : (int)v;
+                if (depotIndex[x] == -1) {
+                    depotIndex[x] = (int)depotTrees.size();
+                    depotTrees.push_back(ShortestPathTree());
+                    depotTrees.back().source = x;
+                }
+            }
+            p = (*endp == ',') ? endp + 1 : endp;
+        }
+        clock_t st = clock();
+        parallelFor((int)depotTrees.size(), threads, [&](int k, int) {
+            buildShortestPathTree(g, timeWeights, depotTrees[k].source, depotTrees[k]);
+        });
+        clock_t ed = clock();
+        cout << "固定起点最短路树: " << depotTrees.size() << " 棵, 构建耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
+    }
+
+    // 单向 Dijkstra 复用同一个工作区，重复查询不再做 O(N) 复位与分配
+    DijkstraWorkspace ws;
+    QuaternaryHeapFrontier quadHeap;
+    RadixHeapFrontier radixHeap;
+    ParetoWorkspace paretoWs;
+
+    if (stats && !perfStatsCompiled()) cerr << "统计计数未编译（需 -DPERF_STATS），仅输出耗时\n";
+    string solverName = useCh ? string("ch") : (algo == "dijkstra" ? "dijkstra/" + frontier : algo);
+
     // 处理 Q 次查询
-    int Q;
-    cin >> Q;
+    int Q = 0;
+    in.readInt(Q);
+    if (batch) {
+        // 批量模式：读入全部查询后分组并行求解，再按原始顺序输出
+        vector<RouteQuery> queries(Q);
+        for (int qi = 0; qi < Q; ++qi) {
+            in.readInt(queries[qi].type);
+            in.readInt(queries[qi].s);
+            in.readInt(queries[qi].t);
+            if (queries[qi].type == 3 || queries[qi].type == 4 || queries[qi].type == 5) {
+                // 批量模式按只读图、单一代价分组求解，不支持在线更新、Pareto 与固定起点查询：置为无效
+                if (queries[qi].type == 3) {
+                    int lights = 0;
+                    in.readInt(lights);
+                }
+                queries[qi].s = 0;
+            } else if (reorder && queries[qi].s >= 1 && queries[qi].s <= N && queries[qi].t >= 1 && queries[qi].t <= N) {
+                queries[qi].s = order.newOf[queries[qi].s];
+                queries[qi].t = order.newOf[queries[qi].t];
+            }
+        }
+        vector<RouteAnswer> answers;
+        runBatchQueries(g, costOf, queries, threads, answers);
+        if (reorder) {
+            for (int qi = 0; qi < Q; ++qi) restorePath(order, answers[qi].path);
+        }
+        for (int qi = 0; qi < Q; ++qi) {
+            const RouteAnswer& ans = answers[qi];
+            if (queries[qi].type == 3) cout << "批量模式不支持在线更新\n";
+            else if (queries[qi].type == 4) cout << "批量模式不支持 Pareto 查询\n";
+            else if (queries[qi].type == 5) cout << "批量模式不支持固定起点查询\n";
+            else if (!ans.valid) cout << "节点编号无效\n";
+            else if (!ans.ok) cout << "无可达路径\n";
+            else printAnswer(queries[qi].type == 2 ? 1 : 0, ans.dist, ans.path, ans.elapsedMs);
+        }
+        return 0;
+    }
     for (int qi = 0; qi < Q; ++qi) {
-        int type, s, t;
-        cin >> type >> s >> t;
+        int type = 0;
+        in.readInt(type);
+        if (type == 3) {
+            // 在线更新道路拥堵与红绿灯：原地修改 CSR 字段与加权边权，后续查询立即生效
+            int road = 0, lights = 0;
+            double cong = 0.0;
+            in.readInt(road);
+            in.readDouble(cong);
+            in.readInt(lights);
+            if (useCh || algo == "alt") {
+                cout << "当前模式依赖预处理数据，不支持在线更新\n";
+                continue;
+            }
+            vector<EdgeChange> changes;
+            if (!updateRoadTraffic(g, road - 1, cong, lights, lightWait, timeWeights, changes)) {
+                cout << (graphFile ? "快照图为只读，不支持在线更新\n" : "道路序号无效\n");
+                continue;
+            }
+            if (frontier == "radix") {
+                for (size_t k = 0; k < changes.size(); ++k) {
+                    int i = changes[k].slot;
+                    radixWeights[1][i] = floor(timeWeights[i] * radixScale + 0.5);
+                }
+            }
+            altReady = false;
+            if (!depotTrees.empty()) {
+                // 只有受这条道路影响的子树重新计算，各棵树并行修复
+                clock_t rst = clock();
+                repairShortestPathTrees(g, timeWeights, changes, depotTrees, threads);
+                clock_t red = clock();
+                cout << "道路 " << road << " 已更新, 已修复 " << depotTrees.size() << " 棵固定起点最短路树, 耗时(毫秒): "
+                     << (1000.0 * (double)(red - rst) / (double)CLOCKS_PER_SEC) << "\n";
+                continue;
+            }
+            cout << "道路 " << road << " 已更新\n";
+            continue;
+        }
+        int s = 0, t = 0;
+        in.readInt(s);
+        in.readInt(t);
         if (s < 1 || s > N || t < 1 || t > N) {
             cout << "节点编号无效\n";
             continue;
         }
+        if (reorder) {
+            s = order.newOf[s];
+            t = order.newOf[t];
+        }
+        if (type == 5) {
+            // 固定起点查询：最短路树随每次更新修复，直接读取到 t 的代价并沿树回溯路径
+            if (depotIndex.empty() || depotIndex[s] == -1) {
+                cout << "起点不是固定起点 (--depots)\n";
+                continue;
+            }
+            clock_t st = clock();
+            const ShortestPathTree& tree = depotTrees[depotIndex[s]];
+            bool ok = tree.dist[t] != numeric_limits<double>::infinity();
+            vector<int> path;
+            if (ok) path = buildPath(g, s, t, tree.prevNode);
+            clock_t ed = clock();
+            if (!ok) {
+                cout << "无可达路径\n";
+                continue;
+            }
+            if (reorder) restorePath(order, path);
+            printAnswer(1, tree.dist[t], path, 1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC);
+            continue;
+        }
+        if (type == 4) {
+            // Pareto 查询：一次双目标搜索，前沿两端即 type=1 与 type=2 的答案；地标下界引导搜索朝向终点
+            if (!altReady) {
+                clock_t pst = clock();
+                for (int mode = 0; mode < 2; ++mode) buildAltLandmarks(g, weightsOf(mode), landmarkCount, alt[mode]);
+                altReady = true;
+                clock_t ped = clock();
+                cout << "Pareto 地标预处理 耗时(毫秒): " << (1000.0 * (double)(ped - pst) / (double)CLOCKS_PER_SEC) << "\n";
+            }
+            vector<ParetoRoute> routes;
+            perfReset();
+            PerfTimer timer;
+            clock_t st = clock();
+            bool ok = paretoSearch(g, weightsOf(0), timeWeights, s, t, paretoLabels, paretoWs, routes, 0, alt);
+            clock_t ed = clock();
+            if (stats) perfWriteJson(cerr, "road", qi + 1, "pareto", timer.elapsedMs());
+            if (!ok) {
+                cout << "无可达路径\n";
+                continue;
+            }
+            cout << fixed << setprecision(3);
+            cout << "Pareto 路线数: " << routes.size() << "\n";
+            for (size_t k = 0; k < routes.size(); ++k) {
+                if (reorder) restorePath(order, routes[k].path);
+                cout << "路线 " << (k + 1) << ": 长度 " << routes[k].length << ", 加权通行时间 " << routes[k].time << "\n";
+                cout << "路径: ";
+                printPath(routes[k].path);
+            }
+            cout << "耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
+            continue;
+        }
         // mode=0 按长度；mode=1 按长度*拥堵+红绿灯等待
         int mode = (type == 2 ? 1 : 0);
-        vector<int> prevNode;
-        vector<double> dist;
+        vector<int> path;
+        double best = 0.0;
+        bool ok;
+        long long settled = 0;
+        perfReset();
+        PerfTimer timer;
         clock_t st = clock();
-        bool ok = dijkstra(g, s, t, mode, prevNode, dist);
+        if (useCh) {
+            ok = chQuery(ch[mode], chWs[mode], s, t, path, best);
+        } else {
+            vector<int> prevNode;
+            vector<double> dist;
+            if (algo == "bidir") ok = bidirectionalDijkstra(g, weightsOf(mode), s, t, prevNode, dist, &settled);
+            else if (algo == "alt") ok = altSearch(g, weightsOf(mode), alt[mode], s, t, prevNode, dist, &settled);
+            else if (algo == "delta") {
+                deltaStepping(g, weightsOf(mode), s, delta, deltaPool, prevNode, dist);
+                ok = dist[t] != numeric_limits<double>::infinity();
+            }
+            else if (frontier == "quad") ok = dijkstra(g, costOf[mode], s, t, ws, quadHeap, &settled);
+            else if (frontier == "radix") ok = dijkstra(g, PrecomputedCost(radixWeights[mode]), s, t, ws, radixHeap, &settled);
+            else ok = dijkstra(g, costOf[mode], s, t, ws, &settled);
+            if (ok && algo == "dijkstra") {
+                path = buildPath(ws, s, t);
+                best = ws.distOf(t);
+                if (frontier == "radix") best /= radixScale;
+            } else if (ok) {
+                path = buildPath(g, s, t, prevNode);
+                best = dist[t];
+            }
+        }
         clock_t ed = clock();
+        if (stats) perfWriteJson(cerr, "road", qi + 1, solverName.c_str(), timer.elapsedMs());
         if (!ok) {
             cout << "无可达路径\n";
             continue;
         }
-        vector<int> path = buildPath(s, t, prevNode);
-        if (mode == 0) {
-            cout << fixed << setprecision(3);
-            cout << "最短距离: " << dist[t] << "\n";
-            cout << "路径: ";
-            printPath(path);
-            cout << "耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
-        } else {
-            cout << fixed << setprecision(3);
-            cout << "最短加权通行时间: " << dist[t] << "\n";
-            cout << "路径: ";
-            printPath(path);
-            cout << "耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
+        if (reorder) restorePath(order, path);
+        // 双向 / ALT 额外报告确定节点数；与单向 Dijkstra 的对比要多做一次搜索，只在 --stats 时进行
+        if (!useCh && (algo == "bidir" || algo == "alt")) {
+            cout << "确定节点数: " << settled;
+            if (stats) {
+                long long baseSettled = 0;
+                dijkstra(g, costOf[mode], s, t, ws, &baseSettled);
+                cout << " (单向 Dijkstra: " << baseSettled << ")";
+            }
+            cout << "\n";
         }
+        printAnswer(mode, best, path, 1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC);
     }
     return 0;
 }
@@ -0,0 +1,169 @@
+#include "pareto.h"
+#include <algorithm>
+
+using namespace std;
+
+ParetoLabel::ParetoLabel() : node(0), parent(-1), length(0), time(0), alive(false) {}
+ParetoLabel::ParetoLabel(int v, int p, double len, double tm) : node(v), parent(p), length(len), time(tm), alive(true) {}
+
+ParetoHeapItem::ParetoHeapItem() : length(0), time(0), label(-1) {}
+ParetoHeapItem::ParetoHeapItem(double len, double tm, int id) : length(len), time(tm), label(id) {}
+
+ParetoWorkspace::ParetoWorkspace() : cap(0), epoch(0) {}
+
+// 小根堆：按（长度, 时间）字典序
+struct ParetoHeapGreater {
+    bool operator()(const ParetoHeapItem& a, const ParetoHeapItem& b) const {
+        if (a.length != b.length) return a.length > b.length;
+        return a.time > b.time;
+    }
+};
+
+// 标签集 [bag, bag+k) 中长度不超过 len 的最后一个位置（没有则为 -1）；该标签是这些标签里时间最短的
+static int lastNotLonger(const ParetoHeapItem* bag, int k, double len) {
+    int lo = 0, hi = k;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (bag[mid].length <= len) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo - 1;
+}
+
+static bool dominated(const ParetoHeapItem* bag, int k, double len, double tm) {
+    int p = lastNotLonger(bag, k, len);
+    return p >= 0 && bag[p].time <= tm;
+}
+
+// 超出上限时选择淘汰的中间标签：与前后邻居在两个目标上的归一化间距之和最小者
+static int mostCrowded(const ParetoHeapItem* bag, int k) {
+    double lenRange = bag[k - 1].length - bag[0].length;
+    double timeRange = bag[0].time - bag[k - 1].time;
+    if (lenRange <= 0) lenRange = 1.0;
+    if (timeRange <= 0) timeRange = 1.0;
+    int best = 1;
+    double bestGap = 0;
+    for (int i = 1; i + 1 < k; ++i) {
+        const ParetoHeapItem& a = bag[i - 1];
+        const ParetoHeapItem& b = bag[i + 1];
+        double gap = (b.length - a.length) / lenRange + (a.time - b.time) / timeRange;
+        if (i == 1 || gap < bestGap) {
+            best = i;
+            bestGap = gap;
+        }
+    }
+    return best;
+}
+
+// 把标签 item 插入节点 v 的标签集：删除被它支配的标签，超限时淘汰一个中间标签，返回 item 是否保留
+// 调用前已确认 item 不被该标签集支配
+static bool insertLabel(ParetoWorkspace& ws, int v, const ParetoHeapItem& item, int maxLabels) {
+    vector<ParetoLabel>& labels = ws.labels;
+    ParetoHeapItem* bag = &ws.bag[(size_t)v * ws.cap];
+    int k = ws.bagSize[v];
+    if (k == 0) ws.touched.push_back(v);
+    int pos = lastNotLonger(bag, k, item.length) + 1;
+    int end = pos;
+    while (end < k && bag[end].time >= item.time) labels[bag[end++].label].alive = false;
+    // 删除 [pos, end) 并在 pos 处插入 id
+    if (end == pos) {
+        for (int i = k; i > pos; --i) bag[i] = bag[i - 1];
+        ++k;
+    } else {
+        for (int i = end; i < k; ++i) bag[pos + 1 + i - end] = bag[i];
+        k -= end - pos - 1;
+    }
+    bag[pos] = item;
+    if (k > maxLabels) {
+        int victim = mostCrowded(bag, k);
+        labels[bag[victim].label].alive = false;
+        for (int i = victim + 1; i < k; ++i) bag[i - 1] = bag[i];
+        --k;
+    }
+    ws.bagSize[v] = k;
+    return labels[item.label].alive;
+}
+
+bool paretoSearch(const CsrGraph& g, const vector<double>& lengthW, const vector<double>& timeW, int s, int t, int maxLabels, ParetoWorkspace& ws, vector<ParetoRoute>& routes, long long* settled, const AltLandmarks* bounds) {
+    if (maxLabels < 2) maxLabels = 2;
+    if (ws.cap != maxLabels + 1 || (int)ws.bagSize.size() < g.n + 1) {
+        ws.cap = maxLabels + 1;
+        ws.bag.assign((size_t)(g.n + 1) * ws.cap, ParetoHeapItem());
+        ws.bagSize.assign(g.n + 1, 0);
+        ws.touched.clear();
+    }
+    for (size_t k = 0; k < ws.touched.size(); ++k) ws.bagSize[ws.touched[k]] = 0;
+    ws.touched.clear();
+    ws.labels.clear();
+    ws.heap.clear();
+    routes.clear();
+    if (settled) *settled = 0;
+    if (bounds) {
+        if ((int)ws.boundStamp.size() < g.n + 1) {
+            ws.boundLength.resize(g.n + 1);
+            ws.boundTime.resize(g.n + 1);
+            ws.boundStamp.assign(g.n + 1, 0);
+        }
+        if (++ws.epoch == 0) {
+            fill(ws.boundStamp.begin(), ws.boundStamp.end(), 0u);
+            ws.epoch = 1;
+        }
+    }
+
+    const ParetoHeapItem* targetBag = &ws.bag[(size_t)t * ws.cap];
+    ws.labels.push_back(ParetoLabel(s, -1, 0.0, 0.0));
+    insertLabel(ws, s, ParetoHeapItem(0.0, 0.0, 0), maxLabels);
+    if (bounds) ws.heap.push_back(ParetoHeapItem(altLowerBound(bounds[0], s, t), altLowerBound(bounds[1], s, t), 0));
+    else ws.heap.push_back(ParetoHeapItem(0.0, 0.0, 0));
+
+    while (!ws.heap.empty()) {
+        pop_heap(ws.heap.begin(), ws.heap.end(), ParetoHeapGreater());
+        int id = ws.heap.back().label;
+        ws.heap.pop_back();
+        if (!ws.labels[id].alive) {
+            PERF_INC(PERF_STALE_POPS);
+            continue;
+        }
+        PERF_INC(PERF_SETTLED);
+        if (settled) ++*settled;
+        int u = ws.labels[id].node;
+        if (u == t) continue;    // 终点标签即一条完整路线，不再扩展
+        double lu = ws.labels[id].length, tu = ws.labels[id].time;
+        PERF_ADD(PERF_RELAXED, g.offset[u + 1] - g.offset[u]);
+
+        for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+            int v = g.to[i];
+            double nl = lu + lengthW[i], nt = tu + timeW[i];
+            double hl = 0.0, ht = 0.0;
+            if (bounds) {
+                if (ws.boundStamp[v] != ws.epoch) {
+                    ws.boundStamp[v] = ws.epoch;
+                    ws.boundLength[v] = altLowerBound(bounds[0], v, t);
+                    ws.boundTime[v] = altLowerBound(bounds[1], v, t);
+                }
+                hl = ws.boundLength[v];
+                ht = ws.boundTime[v];
+            }
+            // 终点已有路线在两个目标上都不差于本标签的下界时，任何延伸都不会进入前沿
+            if (dominated(targetBag, ws.bagSize[t], nl + hl, nt + ht)) continue;
+            if (v != t && dominated(&ws.bag[(size_t)v * ws.cap], ws.bagSize[v], nl, nt)) continue;
+            ParetoHeapItem item(nl, nt, (int)ws.labels.size());
+            ws.labels.push_back(ParetoLabel(v, id, nl, nt));
+            if (!insertLabel(ws, v, item, maxLabels)) continue;
+            PERF_INC(PERF_PUSHES);
+            ws.heap.push_back(ParetoHeapItem(nl + hl, nt + ht, item.label));
+            push_heap(ws.heap.begin(), ws.heap.end(), ParetoHeapGreater());
+        }
+    }
+
+    for (int k = 0; k < ws.bagSize[t]; ++k) {
+        int last = targetBag[k].label;
+        ParetoRoute r;
+        r.length = ws.labels[last].length;
+        r.time = ws.labels[last].time;
+        for (int id = last; id != -1; id = ws.labels[id].parent) r.path.push_back(ws.labels[id].node);
+        reverse(r.path.begin(), r.path.end());
+        routes.push_back(r);
+    }
+    return !routes.empty();
+}
@@ -0,0 +1,64 @@
+#ifndef PARETO_H
+#define PARETO_H
+
+// 双目标（长度, 加权通行时间）Pareto 路线搜索
+// 标签设定法：堆按（长度, 时间）字典序弹出标签，每个节点维护互不支配的标签集（按长度升序、时间降序）
+// 入堆前做支配剪枝：被本节点标签或终点已有路线支配的标签直接丢弃
+// 标签集有上限：超出时淘汰“拥挤度”最小的中间标签，但从不淘汰长度最短（第一个）与时间最短（最后一个）的标签，
+// 因此返回的前沿两端分别就是按长度与按通行时间的最短路，一次搜索即可同时回答 type=1 与 type=2
+// 可选传入两种模式的 ALT 地标表作为到终点的下界：堆按（长度+下界, 时间+下界）排序，
+// 与终点路线比较时也加上下界，只向终点方向扩展（多目标 A*）
+
+#include <vector>
+#include "graph.h"
+
+// 标签：到达 node 的一条部分路线，parent 为上一段的标签下标（起点为 -1）
+struct ParetoLabel {
+    int node;
+    int parent;
+    double length;
+    double time;
+    bool alive;    // alive：仍在某个节点的标签集中（被支配或被淘汰后置为 false，尚未出堆的不再扩展）
+    ParetoLabel();
+    ParetoLabel(int v, int p, double len, double tm);
+};
+
+// 一条 Pareto 路线
+struct ParetoRoute {
+    double length;
+    double time;
+    std::vector<int> path;
+};
+
+// 堆元素 / 标签集槽位：两个目标值直接存放，比较时不再回读标签池
+// 堆中存放加上下界后的估计值，标签集中存放实际值
+struct ParetoHeapItem {
+    double length;
+    double time;
+    int label;
+    ParetoHeapItem();
+    ParetoHeapItem(double len, double tm, int id);
+};
+
+// 查询工作区：标签池与各节点标签集，按触及列表复位
+// 标签集为定长槽位：节点 v 的标签位于 bag[v*cap, v*cap + bagSize[v])，按长度升序、时间降序
+// 槽位直接保存两个目标值（复用 ParetoHeapItem），支配判断不必回读标签池
+struct ParetoWorkspace {
+    std::vector<ParetoLabel> labels;
+    std::vector<ParetoHeapItem> bag;
+    std::vector<int> bagSize;
+    int cap;    // cap：每个节点的槽位数（maxLabels + 1，插入后再淘汰）
+    std::vector<int> touched;
+    std::vector<ParetoHeapItem> heap;
+    std::vector<double> boundLength, boundTime;    // 各节点到终点的下界缓存（仅使用地标时）
+    std::vector<unsigned> boundStamp;    // boundStamp[v] == epoch：本次查询已计算 v 的下界
+    unsigned epoch;
+    ParetoWorkspace();
+};
+
+// s->t 的 Pareto 前沿：routes 按长度升序（时间降序），routes.front() 为长度最短、routes.back() 为通行时间最短
+// lengthW/timeW：按 CSR 边下标排列的两种边权；maxLabels：每个节点的标签集上限（至少 2）
+// settled 可选：累计出堆的有效标签数；bounds 可选：bounds[0]/bounds[1] 为按长度 / 按通行时间的地标表
+bool paretoSearch(const CsrGraph& g, const std::vector<double>& lengthW, const std::vector<double>& timeW, int s, int t, int maxLabels, ParetoWorkspace& ws, std::vector<ParetoRoute>& routes, long long* settled = 0, const AltLandmarks* bounds = 0);
+
+#endif
@@ -0,0 +1,127 @@
+#include "reorder.h"
+#include <algorithm>
+
+using namespace std;
+
+// 按（度数, 编号）升序比较节点
+struct DegreeLess {
+    const vector<int>* deg;
+    explicit DegreeLess(const vector<int>& d) : deg(&d) {}
+    bool operator()(int a, int b) const {
+        if ((*deg)[a] != (*deg)[b]) return (*deg)[a] < (*deg)[b];
+        return a < b;
+    }
+};
+
+// 从 root 做 BFS，返回最后一层中度数最小的节点；mark 记录本次 BFS 已访问（值为 root）
+static int peripheralNode(const CsrGraph& g, const vector<int>& deg, int root, vector<int>& mark, vector<int>& q) {
+    q.clear();
+    q.push_back(root);
+    mark[root] = root;
+    size_t levelBegin = 0;
+    while (true) {
+        size_t levelEnd = q.size();
+        for (size_t k = levelBegin; k < levelEnd; ++k) {
+            int u = q[k];
+            for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+                int v = g.to[i];
+                if (mark[v] == root) continue;
+                mark[v] = root;
+                q.push_back(v);
+            }
+        }
+        if (q.size() == levelEnd) {
+            int best = q[levelBegin];
+            for (size_t k = levelBegin + 1; k < levelEnd; ++k) {
+                if (DegreeLess(deg)(q[k], best)) best = q[k];
+            }
+            return best;
+        }
+        levelBegin = levelEnd;
+    }
+}
+
+void computeRcmOrder(const CsrGraph& g, NodeOrder& order) {
+    int n = g.n;
+    vector<int> deg(n + 1, 0);
+    for (int v = 1; v <= n; ++v) deg[v] = g.offset[v + 1] - g.offset[v];
+
+    // 分量的起始候选按度数升序尝试
+    vector<int> byDegree;
+    byDegree.reserve(n);
+    for (int v = 1; v <= n; ++v) byDegree.push_back(v);
+    sort(byDegree.begin(), byDegree.end(), DegreeLess(deg));
+
+    vector<char> placed(n + 1, 0);
+    vector<int> mark(n + 1, 0);
+    vector<int> q;
+    vector<int> seq;
+    seq.reserve(n);
+    vector<int> nbr;
+    for (int k = 0; k < n; ++k) {
+        int root = byDegree[k];
+        if (placed[root]) continue;
+        int start = peripheralNode(g, deg, root, mark, q);
+        // Cuthill-McKee：BFS 编号，新发现的邻居按度数升序追加
+        size_t head = seq.size();
+        seq.push_back(start);
+        placed[start] = 1;
+        while (head < seq.size()) {
+            int u = seq[head++];
+            nbr.clear();
+            for (int i = g.offset[u]; i < g.offset[u + 1]; ++i) {
+                int v = g.to[i];
+                if (placed[v]) continue;
+                placed[v] = 1;
+                nbr.push_back(v);
+            }
+            sort(nbr.begin(), nbr.end(), DegreeLess(deg));
+            seq.insert(seq.end(), nbr.begin(), nbr.end());
+        }
+    }
+    reverse(seq.begin(), seq.end());
+
+    order.newOf.assign(n + 1, 0);
+    order.oldOf.assign(n + 1, 0);
+    for (int i = 0; i < n; ++i) {
+        order.oldOf[i + 1] = seq[i];
+        order.newOf[seq[i]] = i + 1;
+    }
+}
+
+void permuteCsrGraph(const CsrGraph& g, const NodeOrder& order, CsrGraph& out) {
+    int n = g.n;
+    out.n = n;
+    out.m = g.m;
+    out.offset.assign(n + 2, 0);
+    for (int v = 1; v <= n; ++v) {
+        int old = order.oldOf[v];
+        out.offset[v + 1] = out.offset[v] + (g.offset[old + 1] - g.offset[old]);
+    }
+    out.to.assign(g.m, 0);
+    out.length.assign(g.m, 0.0);
+    out.congestion.assign(g.m, 1.0);
+    out.lights.assign(g.m, 0);
+
+    vector<int> slotOf(g.m, -1);    // slotOf[旧边下标] = 新边下标
+    for (int v = 1; v <= n; ++v) {
+        int old = order.oldOf[v];
+        int a = out.offset[v];
+        for (int i = g.offset[old]; i < g.offset[old + 1]; ++i, ++a) {
+            out.to[a] = order.newOf[g.to[i]];
+            out.length[a] = g.length[i];
+            out.congestion[a] = g.congestion[i];
+            out.lights[a] = g.lights[i];
+            slotOf[i] = a;
+        }
+    }
+
+    out.roadSlot.assign(g.roadSlot.size(), -1);
+    for (size_t r = 0; r < g.roadSlot.size(); ++r) {
+        if (g.roadSlot[r] >= 0) out.roadSlot[r] = slotOf[g.roadSlot[r]];
+    }
+}
+
+void restorePath(const NodeOrder& order, vector<int>& path) {
+    for (size_t i = 0; i < path.size(); ++i) path[i] = order.oldOf[path[i]];
+}
@@ -0,0 +1,25 @@
+#ifndef REORDER_H
+#define REORDER_H
+
+// 节点重编号：让图上相邻的路口在内存中也相邻，减少 dist[v]/prevNode[v] 等按节点下标访问的缓存缺失
+// 输入不含坐标，因此采用反向 Cuthill-McKee（RCM）序：按 BFS 层次编号、同层按度数从小到大
+// 重编号只在内部生效：查询的起终点用 newOf 换成内部编号，输出路径再用 oldOf 换回原编号
+
+#include <vector>
+#include "graph.h"
+
+struct NodeOrder {
+    std::vector<int> newOf;    // newOf[原编号] = 内部编号（大小 n+1，0 映射到 0）
+    std::vector<int> oldOf;    // oldOf[内部编号] = 原编号
+};
+
+// 计算 RCM 序：每个连通分量从伪外围点（度数最小的 BFS 最远层节点）开始
+void computeRcmOrder(const CsrGraph& g, NodeOrder& order);
+
+// 按 order 重排 CSR 图：节点出边保持原有相对次序，roadSlot 改为新的边下标，道路序号不变
+void permuteCsrGraph(const CsrGraph& g, const NodeOrder& order, CsrGraph& out);
+
+// 把内部编号的路径换回原编号
+void restorePath(const NodeOrder& order, std::vector<int>& path);
+
+#endif
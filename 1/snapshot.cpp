@@ -0,0 +1,101 @@
+#include "snapshot.h"
+#include <cstdio>
+#include <cstring>
+
+using namespace std;
+
+static const char SNAPSHOT_MAGIC[8] = { 'C', 'S', 'R', 'G', 'R', 'A', 'P', 'H' };
+static const unsigned SNAPSHOT_VERSION = 1;
+static const unsigned SNAPSHOT_ENDIAN = 0x01020304;    // 按本机字节序写入，读取时比较即可判断字节序
+
+// 文件头（固定 40 字节）
+struct SnapshotHeader {
+    char magic[8];
+    unsigned version;
+    unsigned endian;
+    int n;
+    int m;
+    long long roadSlots;
+    long long reserved;
+};
+
+// 按 8 字节对齐后的数组长度（字节）
+static size_t alignedBytes(size_t bytes) {
+    return (bytes + 7) & ~(size_t)7;
+}
+
+template <class T>
+static bool writeSection(FILE* f, const CsrArray<T>& a) {
+    size_t bytes = a.size() * sizeof(T);
+    if (bytes && fwrite(a.data(), 1, bytes, f) != bytes) return false;
+    static const char pad[8] = { 0 };
+    size_t padBytes = alignedBytes(bytes) - bytes;
+    return padBytes == 0 || fwrite(pad, 1, padBytes, f) == padBytes;
+}
+
+template <class T>
+static bool mapSection(const MappedFile& map, size_t& pos, size_t count, CsrArray<T>& a) {
+    if (count > map.size / sizeof(T)) return false;    // 头中的长度可能被篡改，先防止乘法溢出
+    size_t bytes = count * sizeof(T);
+    if (pos + bytes > map.size) return false;
+    a.borrow((const T*)(map.data + pos), count);
+    pos += alignedBytes(bytes);
+    return true;
+}
+
+bool writeGraphSnapshot(const CsrGraph& g, const char* file) {
+    FILE* f = fopen(file, "wb");
+    if (!f) return false;
+    SnapshotHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic));
+    h.version = SNAPSHOT_VERSION;
+    h.endian = SNAPSHOT_ENDIAN;
+    h.n = g.n;
+    h.m = g.m;
+    h.roadSlots = (long long)g.roadSlot.size();
+    bool ok = fwrite(&h, sizeof(h), 1, f) == 1
+        && writeSection(f, g.offset) && writeSection(f, g.to)
+        && writeSection(f, g.length) && writeSection(f, g.congestion)
+        && writeSection(f, g.lights) && writeSection(f, g.roadSlot);
+    ok = (fclose(f) == 0) && ok;
+    return ok;
+}
+
+// 映射的数组直接来自文件，使用前逐项校验，截断或损坏的文件不会导致越界读取：
+// offset 从 0 开始单调不减且止于 m，to 为 1..n，roadSlot 为 -1 或有效边下标
+static bool validGraphArrays(const CsrGraph& g, int n, int m) {
+    if (g.offset[0] != 0 || g.offset[n + 1] != m) return false;
+    for (int u = 0; u <= n; ++u) {
+        if (g.offset[u] > g.offset[u + 1]) return false;
+    }
+    for (int i = 0; i < m; ++i) {
+        if (g.to[i] < 1 || g.to[i] > n) return false;
+    }
+    for (size_t k = 0; k < g.roadSlot.size(); ++k) {
+        if (g.roadSlot[k] < -1 || g.roadSlot[k] >= m) return false;
+    }
+    return true;
+}
+
+bool mapGraphSnapshot(const char* file, MappedFile& map, CsrGraph& g) {
+    if (!map.open(file)) return false;
+    if (map.size < sizeof(SnapshotHeader)) return false;
+    SnapshotHeader h;
+    memcpy(&h, map.data, sizeof(h));
+    if (memcmp(h.magic, SNAPSHOT_MAGIC, sizeof(h.magic)) != 0) return false;
+    if (h.version != SNAPSHOT_VERSION || h.endian != SNAPSHOT_ENDIAN) return false;
+    if (h.n < 0 || h.m < 0 || h.roadSlots < 0) return false;
+
+    size_t pos = sizeof(SnapshotHeader);
+    bool ok = mapSection(map, pos, (size_t)h.n + 2, g.offset)
+        && mapSection(map, pos, (size_t)h.m, g.to)
+        && mapSection(map, pos, (size_t)h.m, g.length)
+        && mapSection(map, pos, (size_t)h.m, g.congestion)
+        && mapSection(map, pos, (size_t)h.m, g.lights)
+        && mapSection(map, pos, (size_t)h.roadSlots, g.roadSlot);
+    if (!ok || !validGraphArrays(g, h.n, h.m)) return false;
+    g.n = h.n;
+    g.m = h.m;
+    return true;
+}
@@ -0,0 +1,20 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// 图快照模块：把构建好的 CSR 图写成二进制文件，启动时只读映射（mmap）后直接使用
+// 文件布局：文件头（魔数、版本、字节序标记、n、m、道路数）+ 各数组，每个数组起始按 8 字节对齐
+//   offset(int32 × (n+2)) | to(int32 × m) | length(double × m) | congestion(double × m) | lights(int32 × m) | roadSlot(int32 × 2R)
+// 映射后 CsrGraph 的各数组借用映射内存：无解析、无逐节点分配
+
+#include <cstddef>
+#include "graph.h"
+#include "../common/mapped_file.h"
+
+// 写出快照（graph-pack 步骤）
+bool writeGraphSnapshot(const CsrGraph& g, const char* file);
+
+// 映射快照：成功后 g 的数组指向 map 中的数据，map 须比 g 活得久
+// 版本、字节序或大小不符，或数组内容越界（offset 非单调、to 超出 1..n 等）时返回 false
+bool mapGraphSnapshot(const char* file, MappedFile& map, CsrGraph& g);
+
+#endif
@@ -1,48 +1,288 @@
 #include "bus.h"
-#include <iostream>
+#include <ostream>
 #include <vector>
-#include <queue>
-#include <map>
 #include <string>
-#include <limits>
+#include <algorithm>
+#include "../common/perf_stats.h"
 
 using namespace std;
 
-static const int BIG = 100000;
+BusNetwork::BusNetwork() : L(0), S(0) {}
 
-// Dijkstra 用最小堆元素（状态ID + 距离）
-struct PQItem {
-    int state;
-    int dist;
-    PQItem() : state(0), dist(0) {}
-    PQItem(int s, int d) : state(s), dist(d) {}
-};
+BusRoute::BusRoute() : found(false), transfers(0), stops(0) {}
 
-// 最小堆比较器
-struct PQGreater {
-    bool operator()(const PQItem& a, const PQItem& b) const {
-        return a.dist > b.dist;
+LineDelta::LineDelta() : line(0) {}
+
+TransferWorkspace::TransferWorkspace() : epoch(0) {}
+
+void TransferWorkspace::begin(int L) {
+    if ((int)stamp.size() < L + 1) {
+        dist.resize(L + 1);
+        prevLine.resize(L + 1);
+        prevStation.resize(L + 1);
+        stamp.resize(L + 1, 0);
+        goalStamp.resize(L + 1, 0);
+        bfsQueue.resize(L + 1);
     }
-};
+    if (++epoch == 0) {
+        // epoch 回绕：旧时间戳可能与新值冲突，整体清零一次
+        stamp.assign(stamp.size(), 0);
+        goalStamp.assign(goalStamp.size(), 0);
+        epoch = 1;
+    }
+}
 
-// 拼接某条线路上 A->B 的站点序列到 out
-static bool appendSegment(const vector<int>& lineStations, int fromSid, int toSid, vector<int>& out) {
-    int posFrom = -1, posTo = -1;
-    for (size_t i = 0; i < lineStations.size(); ++i) {
-        if (lineStations[i] == fromSid) posFrom = (int)i;
-        if (lineStations[i] == toSid) posTo = (int)i;
+WeightedWorkspace::WeightedWorkspace() : epoch(0) {
+    bucketMin[0] = bucketMin[1] = 0;
+    bucketMax[0] = bucketMax[1] = -1;
+}
+
+void WeightedWorkspace::begin(int stateCount) {
+    if ((int)stamp.size() < stateCount) {
+        transfers.resize(stateCount);
+        stops.resize(stateCount);
+        prev.resize(stateCount);
+        stamp.resize(stateCount, 0);
+    }
+    for (int c = 0; c < 2; ++c) {
+        for (int s = bucketMin[c]; s <= bucketMax[c]; ++s) bucket[c][s].clear();
+        bucketMin[c] = 0;
+        bucketMax[c] = -1;
     }
+    if (++epoch == 0) {
+        stamp.assign(stamp.size(), 0);
+        epoch = 1;
+    }
+}
+
+// 线路换乘图的一行：按站点编号升序扫描线路 u 经过的站点，首次遇到的邻线记为一条边（换乘站即编号最小的共享站）
+// seenBy[v] == u 表示本行已有 v；每条线路只计算一次，因此不必复位
+static void appendTransferRow(BusNetwork& net, int u, vector<int>& seenBy) {
+    for (int i = net.lineSortedStart[u]; i < net.lineSortedStart[u + 1]; ++i) {
+        int sid = net.lineSortedStop[i];
+        for (int k = net.stationStart[sid]; k < net.stationStart[sid + 1]; ++k) {
+            int v = net.stationLine[k];
+            if (v == u || seenBy[v] == u) continue;
+            seenBy[v] = u;
+            net.transferLine.push_back(v);
+            net.transferStation.push_back(sid);
+        }
+    }
+}
+
+void buildBusNetwork(int S, const vector< vector<int> >& lineStations, BusNetwork& net) {
+    int L = (int)lineStations.size() - 1;
+    net.L = L;
+    net.S = S;
+    net.lineStart.assign(L + 2, 0);
+    net.lineSortedStart.assign(L + 2, 0);
+    net.lineStop.clear();
+    net.lineSortedStop.clear();
+    vector<int> count(S + 1, 0);
+    for (int l = 1; l <= L; ++l) {
+        net.lineStart[l] = (int)net.lineStop.size();
+        net.lineSortedStart[l] = (int)net.lineSortedStop.size();
+        net.lineStop.insert(net.lineStop.end(), lineStations[l].begin(), lineStations[l].end());
+        net.lineSortedStop.insert(net.lineSortedStop.end(), lineStations[l].begin(), lineStations[l].end());
+        vector<int>::iterator first = net.lineSortedStop.begin() + net.lineSortedStart[l];
+        sort(first, net.lineSortedStop.end());
+        net.lineSortedStop.erase(unique(first, net.lineSortedStop.end()), net.lineSortedStop.end());
+        for (int i = net.lineSortedStart[l]; i < (int)net.lineSortedStop.size(); ++i) ++count[net.lineSortedStop[i] + 1];
+    }
+    net.lineStart[L + 1] = (int)net.lineStop.size();
+    net.lineSortedStart[L + 1] = (int)net.lineSortedStop.size();
+
+    // 站点 -> (线路, 位置)：按线路编号顺序填入，各站的线路列表自然升序
+    net.stationStart.assign(S + 1, 0);
+    for (int sid = 0; sid < S; ++sid) net.stationStart[sid + 1] = net.stationStart[sid] + count[sid + 1];
+    net.stationLine.assign(net.stationStart[S], 0);
+    net.stationPos.assign(net.stationStart[S], 0);
+    vector<int> cursor(net.stationStart.begin(), net.stationStart.end() - 1);
+    vector<int> lastPos(S, -1);
+    for (int l = 1; l <= L; ++l) {
+        for (size_t j = 0; j < lineStations[l].size(); ++j) lastPos[lineStations[l][j]] = (int)j;
+        for (int i = net.lineSortedStart[l]; i < net.lineSortedStart[l + 1]; ++i) {
+            int sid = net.lineSortedStop[i];
+            net.stationLine[cursor[sid]] = l;
+            net.stationPos[cursor[sid]] = lastPos[sid];
+            ++cursor[sid];
+        }
+    }
+
+    // 综合最优的状态空间：每个位置记录所属线路，以及该站在本线路上最后一次出现的位置（即状态编号）
+    net.stopLine.assign(net.lineStop.size(), 0);
+    net.stopState.assign(net.lineStop.size(), 0);
+    for (int l = 1; l <= L; ++l) {
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) {
+            net.stopLine[i] = l;
+        }
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) lastPos[net.lineStop[i]] = i;
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) net.stopState[i] = lastPos[net.lineStop[i]];
+    }
+
+    net.transferStart.assign(L + 2, 0);
+    net.transferLine.clear();
+    net.transferStation.clear();
+    vector<int> seenBy(L + 1, 0);
+    for (int u = 1; u <= L; ++u) {
+        net.transferStart[u] = (int)net.transferLine.size();
+        appendTransferRow(net, u, seenBy);
+    }
+    net.transferStart[L + 1] = (int)net.transferLine.size();
+}
+
+void applyLineDeltas(const BusNetwork& old, int S, const vector<LineDelta>& deltas, BusNetwork& net) {
+    // changed[l]：线路 l 最后一次变更在 deltas 中的下标，未变更为 -1
+    int L = old.L;
+    for (size_t k = 0; k < deltas.size(); ++k) {
+        if (deltas[k].line == 0) ++L;
+    }
+    vector<int> changed(L + 1, -1);
+    int added = old.L;
+    for (size_t k = 0; k < deltas.size(); ++k) changed[deltas[k].line == 0 ? ++added : deltas[k].line] = (int)k;
+
+    // 线路站点序列：未变更线路整段复制
+    net.L = L;
+    net.S = S;
+    net.lineStart.assign(L + 2, 0);
+    net.lineSortedStart.assign(L + 2, 0);
+    net.lineStop.clear();
+    net.lineSortedStop.clear();
+    net.lineStop.reserve(old.lineStop.size());
+    net.lineSortedStop.reserve(old.lineSortedStop.size());
+    for (int l = 1; l <= L; ++l) {
+        net.lineStart[l] = (int)net.lineStop.size();
+        net.lineSortedStart[l] = (int)net.lineSortedStop.size();
+        if (changed[l] == -1) {
+            net.lineStop.insert(net.lineStop.end(), old.lineStop.begin() + old.lineStart[l], old.lineStop.begin() + old.lineStart[l + 1]);
+            net.lineSortedStop.insert(net.lineSortedStop.end(), old.lineSortedStop.begin() + old.lineSortedStart[l], old.lineSortedStop.begin() + old.lineSortedStart[l + 1]);
+            continue;
+        }
+        const vector<int>& seq = deltas[changed[l]].stations;
+        net.lineStop.insert(net.lineStop.end(), seq.begin(), seq.end());
+        net.lineSortedStop.insert(net.lineSortedStop.end(), seq.begin(), seq.end());
+        vector<int>::iterator first = net.lineSortedStop.begin() + net.lineSortedStart[l];
+        sort(first, net.lineSortedStop.end());
+        net.lineSortedStop.erase(unique(first, net.lineSortedStop.end()), net.lineSortedStop.end());
+    }
+    net.lineStart[L + 1] = (int)net.lineStop.size();
+    net.lineSortedStart[L + 1] = (int)net.lineSortedStop.size();
+
+    // 状态空间：未变更线路的状态编号整体平移
+    net.stopLine.assign(net.lineStop.size(), 0);
+    net.stopState.assign(net.lineStop.size(), 0);
+    vector<int> lastPos(S, -1);
+    for (int l = 1; l <= L; ++l) {
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) net.stopLine[i] = l;
+        if (changed[l] == -1) {
+            int shift = net.lineStart[l] - old.lineStart[l];
+            for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) net.stopState[i] = old.stopState[i - shift] + shift;
+            continue;
+        }
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) lastPos[net.lineStop[i]] = i;
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) net.stopState[i] = lastPos[net.lineStop[i]];
+    }
+
+    // 站点 -> (线路, 位置)：旧列表去掉变更线路，再按线路编号归并变更线路的新条目（未涉及的站点即原样复制）
+    vector< pair<int, pair<int,int> > > additions;
+    for (int l = 1; l <= L; ++l) {
+        if (changed[l] == -1) continue;
+        for (int i = net.lineStart[l]; i < net.lineStart[l + 1]; ++i) lastPos[net.lineStop[i]] = i - net.lineStart[l];
+        for (int i = net.lineSortedStart[l]; i < net.lineSortedStart[l + 1]; ++i) {
+            int sid = net.lineSortedStop[i];
+            additions.push_back(make_pair(sid, make_pair(l, lastPos[sid])));
+        }
+    }
+    sort(additions.begin(), additions.end());
+    net.stationStart.assign(S + 1, 0);
+    net.stationLine.clear();
+    net.stationPos.clear();
+    net.stationLine.reserve(old.stationLine.size() + additions.size());
+    net.stationPos.reserve(old.stationLine.size() + additions.size());
+    size_t a = 0;
+    for (int sid = 0; sid < S; ++sid) {
+        net.stationStart[sid] = (int)net.stationLine.size();
+        int k = sid < old.S ? old.stationStart[sid] : 0;
+        int kEnd = sid < old.S ? old.stationStart[sid + 1] : 0;
+        for (;;) {
+            while (k < kEnd && changed[old.stationLine[k]] != -1) ++k;
+            bool haveAdd = a < additions.size() && additions[a].first == sid;
+            if (k == kEnd && !haveAdd) break;
+            if (haveAdd && (k == kEnd || additions[a].second.first < old.stationLine[k])) {
+                net.stationLine.push_back(additions[a].second.first);
+                net.stationPos.push_back(additions[a].second.second);
+                ++a;
+            } else {
+                net.stationLine.push_back(old.stationLine[k]);
+                net.stationPos.push_back(old.stationPos[k]);
+                ++k;
+            }
+        }
+    }
+    net.stationStart[S] = (int)net.stationLine.size();
+
+    // 换乘图：变更线路及其新旧邻线重算整行，其余各行的邻线与换乘站都不变，整行复制
+    vector<char> affected(L + 1, 0);
+    for (int l = 1; l <= L; ++l) {
+        if (changed[l] == -1) continue;
+        affected[l] = 1;
+        if (l <= old.L) {
+            for (int e = old.transferStart[l]; e < old.transferStart[l + 1]; ++e) affected[old.transferLine[e]] = 1;
+        }
+        for (int i = net.lineSortedStart[l]; i < net.lineSortedStart[l + 1]; ++i) {
+            int sid = net.lineSortedStop[i];
+            for (int k = net.stationStart[sid]; k < net.stationStart[sid + 1]; ++k) affected[net.stationLine[k]] = 1;
+        }
+    }
+    net.transferStart.assign(L + 2, 0);
+    net.transferLine.clear();
+    net.transferStation.clear();
+    net.transferLine.reserve(old.transferLine.size());
+    net.transferStation.reserve(old.transferStation.size());
+    vector<int> seenBy(L + 1, 0);
+    for (int u = 1; u <= L; ++u) {
+        net.transferStart[u] = (int)net.transferLine.size();
+        if (affected[u]) {
+            appendTransferRow(net, u, seenBy);
+            continue;
+        }
+        net.transferLine.insert(net.transferLine.end(), old.transferLine.begin() + old.transferStart[u], old.transferLine.begin() + old.transferStart[u + 1]);
+        net.transferStation.insert(net.transferStation.end(), old.transferStation.begin() + old.transferStart[u], old.transferStation.begin() + old.transferStart[u + 1]);
+    }
+    net.transferStart[L + 1] = (int)net.transferLine.size();
+}
+
+// (站点, 线路) 对在 stationLine 中的下标，站点不在线路上返回 -1
+static int pairIndex(const BusNetwork& net, int sid, int line) {
+    const int* first = &net.stationLine[0] + net.stationStart[sid];
+    const int* last = &net.stationLine[0] + net.stationStart[sid + 1];
+    const int* it = lower_bound(first, last, line);
+    if (it == last || *it != line) return -1;
+    return (int)(it - &net.stationLine[0]);
+}
+
+int stopPosition(const BusNetwork& net, int line, int sid) {
+    if (net.stationLine.empty()) return -1;
+    int k = pairIndex(net, sid, line);
+    return k == -1 ? -1 : net.stationPos[k];
+}
+
+// 拼接某条线路上 A->B 的站点序列到 out
+static bool appendSegment(const BusNetwork& net, int line, int fromSid, int toSid, vector<int>& out) {
+    int posFrom = stopPosition(net, line, fromSid);
+    int posTo = stopPosition(net, line, toSid);
     if (posFrom == -1 || posTo == -1) return false;
 
+    const int* stops = &net.lineStop[0] + net.lineStart[line];
     if (posFrom <= posTo) {
         for (int i = posFrom; i <= posTo; ++i) {
-            int sid = lineStations[i];
+            int sid = stops[i];
             if (!out.empty() && out.back() == sid) continue;
             out.push_back(sid);
         }
     } else {
         for (int i = posFrom; i >= posTo; --i) {
-            int sid = lineStations[i];
+            int sid = stops[i];
             if (!out.empty() && out.back() == sid) continue;
             out.push_back(sid);
         }
@@ -51,265 +291,282 @@ static bool appendSegment(const vector<int>& lineStations, int fromSid, int toSi
 }
 
 // 打印站点序列（用名称）
-static void printStationSeq(const vector<int>& stationSeq, const vector<string>& nameOf) {
+static void printStationSeq(ostream& out, const vector<int>& stationSeq, const StationTable& names) {
     for (size_t i = 0; i < stationSeq.size(); ++i) {
-        if (i) cout << " -> ";
+        if (i) out << " -> ";
         int sid = stationSeq[i];
-        cout << nameOf[sid];
+        out << names.name(sid);
     }
-    cout << "\n";
+    out << "\n";
 }
 
-// 最少换乘（以线路为节点做 BFS）
-void solveMinTransfers(
-    int L,
-    const vector< vector<int> >& lineStations,
-    const vector< vector<int> >& stationLines,
-    const vector< vector<char> >& inLine,
-    int startSid,
-    int endSid,
-    const vector<string>& nameOf
-) {
-    vector<char> isGoal(L + 1, 0);
-    for (size_t i = 0; i < stationLines[endSid].size(); ++i) isGoal[stationLines[endSid][i]] = 1;
-
-    vector<int> dist(L + 1, -1);
-    vector<int> prevLine(L + 1, -1);
-    vector<int> prevStation(L + 1, -1);
-    queue<int> q;
-
-    for (size_t i = 0; i < stationLines[startSid].size(); ++i) {
-        int l = stationLines[startSid][i];
-        dist[l] = 0;
-        q.push(l);
-    }
-
-    int goalLine = -1;
-    while (!q.empty()) {
-        int u = q.front();
-        q.pop();
-        if (isGoal[u]) {
-            goalLine = u;
-            break;
-        }
-        for (int sid = 0; sid < (int)stationLines.size(); ++sid) {
-            if (!inLine[u][sid]) continue;
-            const vector<int>& linesHere = stationLines[sid];
-            for (size_t k = 0; k < linesHere.size(); ++k) {
-                int v = linesHere[k];
-                if (v == u) continue;
-                if (dist[v] != -1) continue;
-                dist[v] = dist[u] + 1;
-                prevLine[v] = u;
-                prevStation[v] = sid;
-                q.push(v);
-            }
-        }
+// 打印线路序列，无线路时输出“（无）”
+static void printLineSeq(ostream& out, const vector<int>& lineSeq) {
+    if (lineSeq.empty()) out << "（无）";
+    for (size_t i = 0; i < lineSeq.size(); ++i) {
+        if (i) out << " -> ";
+        out << "L" << lineSeq[i];
     }
+    out << "\n";
+}
 
-    if (goalLine == -1) {
-        cout << "无可达路线\n";
-        return;
+// 清空上次查询留下的结果（保留容量）
+static void resetRoute(BusRoute& route) {
+    route.found = false;
+    route.transfers = 0;
+    route.stops = 0;
+    route.lines.clear();
+    route.transferStations.clear();
+    route.stations.clear();
+}
+
+int transferBfs(const BusNetwork& net, const int* sources, int sourceCount, const int* goals, int goalCount, TransferWorkspace& ws) {
+    ws.begin(net.L);
+    unsigned epoch = ws.epoch;
+    for (int i = 0; i < goalCount; ++i) ws.goalStamp[goals[i]] = epoch;
+
+    int head = 0, tail = 0;
+    for (int i = 0; i < sourceCount; ++i) {
+        int l = sources[i];
+        if (ws.stamp[l] == epoch) continue;
+        ws.stamp[l] = epoch;
+        ws.dist[l] = 0;
+        ws.prevLine[l] = -1;
+        ws.prevStation[l] = -1;
+        PERF_INC(PERF_STATES_PUSHED);
+        ws.bfsQueue[tail++] = l;
     }
 
-    vector<int> lineSeq;
-    vector<int> transferStations;
+    while (head < tail) {
+        int u = ws.bfsQueue[head++];
+        if (ws.goalStamp[u] == epoch) return u;
+        PERF_INC(PERF_LINES_EXPANDED);
+        for (int e = net.transferStart[u]; e < net.transferStart[u + 1]; ++e) {
+            int v = net.transferLine[e];
+            if (ws.stamp[v] == epoch) continue;
+            ws.stamp[v] = epoch;
+            ws.dist[v] = ws.dist[u] + 1;
+            ws.prevLine[v] = u;
+            ws.prevStation[v] = net.transferStation[e];
+            PERF_INC(PERF_STATES_PUSHED);
+            ws.bfsQueue[tail++] = v;
+        }
+    }
+    return -1;
+}
+
+// 最少换乘（在线路换乘图上做 BFS）：起点站的线路为源，终点站的线路为目标
+bool solveMinTransfers(
+    const BusNetwork& net,
+    int startSid,
+    int endSid,
+    TransferWorkspace& ws,
+    BusRoute& route
+) {
+    resetRoute(route);
+    const int* lines = net.stationLine.empty() ? 0 : &net.stationLine[0];
+    int goalLine = transferBfs(net,
+        lines + net.stationStart[startSid], net.stationStart[startSid + 1] - net.stationStart[startSid],
+        lines + net.stationStart[endSid], net.stationStart[endSid + 1] - net.stationStart[endSid], ws);
+    if (goalLine == -1) return false;
+
+    vector<int>& lineSeq = route.lines;
+    vector<int>& transferStations = route.transferStations;
     int cur = goalLine;
     while (cur != -1) {
         lineSeq.push_back(cur);
-        int ps = prevStation[cur];
+        int ps = ws.prevStation[cur];
         if (ps != -1) transferStations.push_back(ps);
-        cur = prevLine[cur];
+        cur = ws.prevLine[cur];
     }
     for (size_t i = 0, j = lineSeq.size() - 1; i < j; ++i, --j) {
         int tmp = lineSeq[i]; lineSeq[i] = lineSeq[j]; lineSeq[j] = tmp;
     }
-    for (size_t i = 0, j = transferStations.size() - 1; i < j; ++i, --j) {
-        int tmp = transferStations[i]; transferStations[i] = transferStations[j]; transferStations[j] = tmp;
+    // 零换乘时 transferStations 为空，size()-1 会下溢
+    for (size_t i = 0, j = transferStations.size(); i + 1 < j; ++i, --j) {
+        int tmp = transferStations[i]; transferStations[i] = transferStations[j - 1]; transferStations[j - 1] = tmp;
     }
 
-    int transfers = (int)lineSeq.size() - 1;
-    cout << "最少换乘次数: " << transfers << "\n";
-    cout << "线路序列: ";
-    for (size_t i = 0; i < lineSeq.size(); ++i) {
-        if (i) cout << " -> ";
-        cout << "L" << lineSeq[i];
-    }
-    cout << "\n";
-
-    vector<int> stationSeq;
+    vector<int>& stationSeq = route.stations;
     if (lineSeq.size() == 1) {
-        appendSegment(lineStations[lineSeq[0]], startSid, endSid, stationSeq);
+        appendSegment(net, lineSeq[0], startSid, endSid, stationSeq);
     } else {
         int firstTransferSid = transferStations[0];
-        appendSegment(lineStations[lineSeq[0]], startSid, firstTransferSid, stationSeq);
+        appendSegment(net, lineSeq[0], startSid, firstTransferSid, stationSeq);
         for (size_t i = 1; i + 1 < lineSeq.size(); ++i) {
             int aSid = transferStations[i - 1];
             int bSid = transferStations[i];
-            appendSegment(lineStations[lineSeq[i]], aSid, bSid, stationSeq);
+            appendSegment(net, lineSeq[i], aSid, bSid, stationSeq);
         }
         int lastTransferSid = transferStations[transferStations.size() - 1];
-        appendSegment(lineStations[lineSeq[lineSeq.size() - 1]], lastTransferSid, endSid, stationSeq);
+        appendSegment(net, lineSeq[lineSeq.size() - 1], lastTransferSid, endSid, stationSeq);
     }
-    cout << "站点序列: ";
-    printStationSeq(stationSeq, nameOf);
-}
-
-// 状态键：站点 + 当前线路（0 表示未选择线路）
-struct StateKey {
-    int station;
-    int line;
-    StateKey() : station(0), line(0) {}
-    StateKey(int s, int l) : station(s), line(l) {}
-};
-
-static long long packKey(int station, int line, int L) {
-    return (long long)station * (long long)(L + 1) + (long long)line;
+    route.found = true;
+    route.transfers = (int)lineSeq.size() - 1;
+    route.stops = (int)stationSeq.size() - 1;
+    return true;
 }
 
-void solveWeighted(
-    int L,
-    const vector< vector<int> >& lineStations,
-    const vector< vector<int> >& stationLines,
-    const vector< vector<int> >& posInLine,
-    int startSid,
-    int endSid,
-    const vector<string>& nameOf
-) {
-    if (startSid == endSid) {
-        cout << "换乘次数: 0, 总站数: 0\n";
-        cout << "站点序列: " << nameOf[startSid] << "\n";
-        cout << "线路序列: （无）\n";
+void printMinTransfers(ostream& out, const BusRoute& route, const StationTable& names) {
+    if (!route.found) {
+        out << "无可达路线\n";
         return;
     }
+    out << "最少换乘次数: " << route.transfers << "\n";
+    out << "线路序列: ";
+    printLineSeq(out, route.lines);
+    out << "站点序列: ";
+    printStationSeq(out, route.stations, names);
+}
 
-    map<long long, int> stateId;
-    vector<StateKey> idToKey;
-
-    int startState = 0;
-    stateId[packKey(startSid, 0, L)] = 0;
-    idToKey.push_back(StateKey(startSid, 0));
+// 字典序比较 (t1, s1) < (t2, s2)
+static bool lexLess(int t1, int s1, int t2, int s2) {
+    return t1 < t2 || (t1 == t2 && s1 < s2);
+}
 
-    for (int sid = 0; sid < (int)stationLines.size(); ++sid) {
-        for (size_t i = 0; i < stationLines[sid].size(); ++i) {
-            int l = stationLines[sid][i];
-            long long k = packKey(sid, l, L);
-            if (stateId.find(k) != stateId.end()) continue;
-            int id = (int)idToKey.size();
-            stateId[k] = id;
-            idToKey.push_back(StateKey(sid, l));
-        }
+// 桶队列入队：第 t 层、站数 s
+static void pushBucket(WeightedWorkspace& ws, int t, int s, int state) {
+    int c = t & 1;
+    if ((int)ws.bucket[c].size() <= s) ws.bucket[c].resize(s + 1);
+    ws.bucket[c][s].push_back(state);
+    if (ws.bucketMin[c] > ws.bucketMax[c]) ws.bucketMin[c] = ws.bucketMax[c] = s;
+    else {
+        if (s < ws.bucketMin[c]) ws.bucketMin[c] = s;
+        if (s > ws.bucketMax[c]) ws.bucketMax[c] = s;
     }
+    PERF_INC(PERF_STATES_PUSHED);
+}
 
-    int S = (int)idToKey.size();
-    vector<int> dist(S, numeric_limits<int>::max());
-    vector<int> prev(S, -1);
-
-    priority_queue<PQItem, vector<PQItem>, PQGreater> pq;
-    dist[startState] = 0;
-    pq.push(PQItem(startState, 0));
-
-    while (!pq.empty()) {
-        PQItem cur = pq.top();
-        pq.pop();
-        int u = cur.state;
-        if (cur.dist != dist[u]) continue;
-
-        int station = idToKey[u].station;
-        int line = idToKey[u].line;
-
-        if (station == endSid && line != 0) break;
-
-        const vector<int>& linesHere = stationLines[station];
-        for (size_t i = 0; i < linesHere.size(); ++i) {
-            int l2 = linesHere[i];
-            int add = 0;
-            if (line == 0) add = 0;
-            else if (l2 != line) add = BIG;
+// 松弛：以 (t, s) 到达状态 v，前驱 u（-1 表示起点）
+static void relaxState(WeightedWorkspace& ws, int v, int t, int s, int u) {
+    if (ws.stamp[v] == ws.epoch && !lexLess(t, s, ws.transfers[v], ws.stops[v])) return;
+    ws.stamp[v] = ws.epoch;
+    ws.transfers[v] = t;
+    ws.stops[v] = s;
+    ws.prev[v] = u;
+    pushBucket(ws, t, s, v);
+}
 
-            int v = stateId[packKey(station, l2, L)];
-            if (dist[u] + add < dist[v]) {
-                dist[v] = dist[u] + add;
-                prev[v] = u;
-                pq.push(PQItem(v, dist[v]));
-            }
-        }
+void weightedSearch(const BusNetwork& net, int startSid, int endSid, WeightedWorkspace& ws) {
+    // 起点站的各条线路为源（换乘 0 次、站数 0）；状态编号见 BusNetwork 注释
+    ws.begin((int)net.lineStop.size());
+    for (int k = net.stationStart[startSid]; k < net.stationStart[startSid + 1]; ++k) {
+        relaxState(ws, net.lineStart[net.stationLine[k]] + net.stationPos[k], 0, 0, -1);
+    }
 
-        if (line != 0) {
-            int pos = posInLine[line][station];
-            if (pos != -1) {
-                if (pos - 1 >= 0) {
-                    int ns = lineStations[line][pos - 1];
-                    int v = stateId[packKey(ns, line, L)];
-                    if (dist[u] + 1 < dist[v]) {
-                        dist[v] = dist[u] + 1;
-                        prev[v] = u;
-                        pq.push(PQItem(v, dist[v]));
-                    }
+    // 逐层处理：第 t 层按站数升序出队，换乘进入第 t+1 层，沿线移动留在本层的下一个桶
+    bool found = false;
+    for (int t = 0; !found; ++t) {
+        int c = t & 1;
+        if (ws.bucketMin[c] > ws.bucketMax[c]) break;
+        for (int s = ws.bucketMin[c]; s <= ws.bucketMax[c] && !found; ++s) {
+            // 先扩好本轮可能写入的桶（本层 s+1、下一层 s），避免入队时外层数组扩容使 b 失效
+            if ((int)ws.bucket[c].size() < s + 2) ws.bucket[c].resize(s + 2);
+            if ((int)ws.bucket[c ^ 1].size() < s + 1) ws.bucket[c ^ 1].resize(s + 1);
+            vector<int>& b = ws.bucket[c][s];
+            for (size_t i = 0; i < b.size(); ++i) {
+                int u = b[i];
+                if (ws.transfers[u] != t || ws.stops[u] != s) {
+                    PERF_INC(PERF_STALE_POPS);
+                    continue;
                 }
-                if (pos + 1 < (int)lineStations[line].size()) {
-                    int ns = lineStations[line][pos + 1];
-                    int v = stateId[packKey(ns, line, L)];
-                    if (dist[u] + 1 < dist[v]) {
-                        dist[v] = dist[u] + 1;
-                        prev[v] = u;
-                        pq.push(PQItem(v, dist[v]));
-                    }
+                int station = net.lineStop[u];
+                int line = net.stopLine[u];
+                if (station == endSid) {
+                    found = true;
+                    break;
                 }
+                PERF_INC(PERF_LINES_EXPANDED);
+
+                // 同站换乘到其他线路
+                for (int k = net.stationStart[station]; k < net.stationStart[station + 1]; ++k) {
+                    int l2 = net.stationLine[k];
+                    if (l2 == line) continue;
+                    relaxState(ws, net.lineStart[l2] + net.stationPos[k], t + 1, s, u);
+                }
+                // 沿线路移动到相邻站（从该站最后一次出现的位置出发）
+                if (u - 1 >= net.lineStart[line]) relaxState(ws, net.stopState[u - 1], t, s + 1, u);
+                if (u + 1 < net.lineStart[line + 1]) relaxState(ws, net.stopState[u + 1], t, s + 1, u);
             }
+            // 提前结束时保留桶的内容与范围，由下次 begin 清空
+            if (!found) b.clear();
+        }
+        if (!found) {
+            ws.bucketMin[c] = 0;
+            ws.bucketMax[c] = -1;
         }
     }
+}
 
-    int bestState = -1;
-    int bestDist = numeric_limits<int>::max();
-    for (size_t i = 0; i < stationLines[endSid].size(); ++i) {
-        int l = stationLines[endSid][i];
-        int id = stateId[packKey(endSid, l, L)];
-        if (dist[id] < bestDist) {
-            bestDist = dist[id];
-            bestState = id;
-        }
+bool solveWeighted(
+    const BusNetwork& net,
+    int startSid,
+    int endSid,
+    WeightedWorkspace& ws,
+    BusRoute& route
+) {
+    resetRoute(route);
+    if (startSid == endSid) {
+        route.found = true;
+        route.stations.push_back(startSid);
+        return true;
     }
-    if (bestState == -1 || bestDist == numeric_limits<int>::max()) {
-        cout << "无可达路线\n";
-        return;
+
+    weightedSearch(net, startSid, endSid, ws);
+
+    int bestState = -1;
+    for (int k = net.stationStart[endSid]; k < net.stationStart[endSid + 1]; ++k) {
+        int id = net.lineStart[net.stationLine[k]] + net.stationPos[k];
+        if (ws.stamp[id] != ws.epoch) continue;
+        if (bestState == -1 || lexLess(ws.transfers[id], ws.stops[id], ws.transfers[bestState], ws.stops[bestState])) bestState = id;
     }
+    if (bestState == -1) return false;
 
     vector<int> states;
     int cur = bestState;
     while (cur != -1) {
         states.push_back(cur);
-        cur = prev[cur];
+        cur = ws.prev[cur];
     }
     for (size_t i = 0, j = states.size() - 1; i < j; ++i, --j) {
         int tmp = states[i]; states[i] = states[j]; states[j] = tmp;
     }
 
-    vector<int> stationSeq;
-    vector<int> lineSeq;
+    // 线路变化处即一次换乘（换乘前后两个状态在同一站）
+    vector<int>& stationSeq = route.stations;
     int lastLine = 0;
+    stationSeq.push_back(startSid);
     for (size_t i = 0; i < states.size(); ++i) {
-        int sid = idToKey[states[i]].station;
-        int l = idToKey[states[i]].line;
+        int sid = net.lineStop[states[i]];
+        int l = net.stopLine[states[i]];
         if (stationSeq.empty() || stationSeq.back() != sid) stationSeq.push_back(sid);
         if (l != 0 && l != lastLine) {
-            lineSeq.push_back(l);
+            if (lastLine != 0) route.transferStations.push_back(sid);
+            route.lines.push_back(l);
             lastLine = l;
         }
     }
+    route.found = true;
+    route.transfers = ws.transfers[bestState];
+    route.stops = ws.stops[bestState];
+    return true;
+}
 
-    int transfers = bestDist / BIG;
-    int stops = bestDist % BIG;
-    cout << "换乘次数: " << transfers << ", 总站数: " << stops << "\n";
-    cout << "线路序列: ";
-    if (lineSeq.empty()) cout << "（无）\n";
-    else {
-        for (size_t i = 0; i < lineSeq.size(); ++i) {
-            if (i) cout << " -> ";
-            cout << "L" << lineSeq[i];
-        }
-        cout << "\n";
+void printWeighted(ostream& out, const BusRoute& route, const StationTable& names) {
+    if (!route.found) {
+        out << "无可达路线\n";
+        return;
+    }
+    if (route.lines.empty()) {
+        // 起点即终点：不乘车
+        out << "换乘次数: 0, 总站数: 0\n";
+        out << "站点序列: " << names.name(route.stations[0]) << "\n";
+        out << "线路序列: （无）\n";
+        return;
     }
-    cout << "站点序列: ";
-    printStationSeq(stationSeq, nameOf);
+    out << "换乘次数: " << route.transfers << ", 总站数: " << route.stops << "\n";
+    out << "线路序列: ";
+    printLineSeq(out, route.lines);
+    out << "站点序列: ";
+    printStationSeq(out, route.stations, names);
 }
@@ -2,39 +2,135 @@
 #define BUS_H
 
 // 公交换乘优化模块（中文注释）
-// 提供最少换乘与综合（换乘+总站数）求解接口
+// 提供最少换乘与综合（换乘+总站数）求解接口；求解只写结果结构，不做输出，网络只读，多个线程各用自己的工作区即可并发查询
 
 #include <vector>
 #include <string>
+#include <ostream>
+#include "station_table.h"
+
+// 公交网络的紧凑索引（CSR 形式），内存与线路站点总数 T 成正比，不随 L*S 增长
+// 线路 l（1..L）的站点序列：lineStop[lineStart[l] .. lineStart[l+1])
+// 同一线路按站点编号升序去重：lineSortedStop[lineSortedStart[l] .. lineSortedStart[l+1])（BFS 按此顺序扫描）
+// 站点 sid 所在线路：stationLine[stationStart[sid] .. stationStart[sid+1])，线路编号升序、不重复；
+// stationPos 为该站在对应线路上的位置，线路多次经过同一站时取最后一次
+// 线路换乘图：线路 u 可换乘的线路为 transferLine[transferStart[u] .. transferStart[u+1])，
+// transferStation 为对应的换乘站（两线共享站点中编号最小者）；每对线路只保留一条边
+// 综合最优的状态 (站点, 线路) 编号为 lineStart[line] + 该站在线路上的位置（最后一次出现），即 lineStop 的下标；
+// stopLine[i] 为位置 i 所属线路，stopState[i] 为位置 i 上的站点在本线路的状态编号（重复经过时指向最后一次）
+struct BusNetwork {
+    int L;
+    int S;
+    std::vector<int> lineStart;
+    std::vector<int> lineStop;
+    std::vector<int> lineSortedStart;
+    std::vector<int> lineSortedStop;
+    std::vector<int> stationStart;
+    std::vector<int> stationLine;
+    std::vector<int> stationPos;
+    std::vector<int> transferStart;
+    std::vector<int> transferLine;
+    std::vector<int> transferStation;
+    std::vector<int> stopLine;
+    std::vector<int> stopState;
+    BusNetwork();
+};
+
+// 换乘 BFS 工作区（调用方持有，跨查询复用）：按 epoch 打时间戳，查询之间不做 O(L) 复位与分配
+struct TransferWorkspace {
+    std::vector<int> dist;
+    std::vector<int> prevLine;
+    std::vector<int> prevStation;
+    std::vector<unsigned> stamp;    // stamp[l] == epoch：本次查询已访问 l
+    std::vector<unsigned> goalStamp;    // goalStamp[l] == epoch：l 是本次查询的目标线路
+    std::vector<int> bfsQueue;
+    unsigned epoch;
+    TransferWorkspace();
+    // 开始一次新查询（线路 1..L）：必要时扩容，epoch 回绕时整体清零
+    void begin(int L);
+};
+
+// 综合最优搜索工作区（调用方持有，跨查询复用）：代价为字典序（换乘次数, 站数），用两级桶队列代替二叉堆
+// 换乘边只让换乘次数加 1，沿线移动只让站数加 1，因此任意时刻只有当前层 t 与下一层 t+1 非空，各层内按站数分桶
+struct WeightedWorkspace {
+    std::vector<int> transfers;
+    std::vector<int> stops;
+    std::vector<int> prev;
+    std::vector<unsigned> stamp;    // stamp[u] == epoch：本次查询已写入 transfers/stops/prev
+    unsigned epoch;
+    std::vector< std::vector<int> > bucket[2];    // bucket[t & 1][s]：换乘 t 次、站数 s 的待处理状态
+    int bucketMin[2];    // 各层非空桶的范围（空层 bucketMin > bucketMax）
+    int bucketMax[2];
+    WeightedWorkspace();
+    // 开始一次新查询：必要时扩容，清空上次提前结束时残留的桶，epoch 回绕时整体清零
+    void begin(int stateCount);
+};
+
+// 一次路线查询的结果
+struct BusRoute {
+    bool found;    // 是否可达
+    int transfers;    // 换乘次数
+    int stops;    // 总站数（站点序列的区间数）
+    std::vector<int> lines;    // 依次乘坐的线路；起点即终点时为空
+    std::vector<int> transferStations;    // 各次换乘所在站点，比 lines 少一个
+    std::vector<int> stations;    // 经过的站点，首为起点、尾为终点
+    BusRoute();
+};
+
+// 由各线路站点序列（lineStations[1..L]，站点编号 0..S-1）构建索引与线路换乘图
+void buildBusNetwork(int S, const std::vector< std::vector<int> >& lineStations, BusNetwork& net);
+
+// 一条线路变更：line 为 0 表示新增线路，否则为已有线路的编号；stations 为新的站点序列，为空表示删除该线路
+// 删除后线路编号保留（成为不经过任何站点的空线路），其他线路的编号不变
+struct LineDelta {
+    int line;
+    std::vector<int> stations;
+    LineDelta();
+};
+
+// 在 old 的基础上依次应用 deltas 得到新网络 net（S 为变更后的站点数，不小于 old.S），结果与用变更后的全部线路调用 buildBusNetwork 相同
+// 新增线路依次编号为 old.L+1, old.L+2, ...；未变更线路的站点序列、未涉及站点的线路列表、与变更线路不相邻的换乘图各行整段复制，
+// 只有变更线路、其经过的站点以及新旧邻线的索引项重新计算
+void applyLineDeltas(const BusNetwork& old, int S, const std::vector<LineDelta>& deltas, BusNetwork& net);
+
+// 站点 sid 在线路 line 上的位置（最后一次出现），不在线路上返回 -1
+int stopPosition(const BusNetwork& net, int line, int sid);
+
+// 多源多目标换乘 BFS（在线路换乘图上）：sources 中的线路换乘 0 次，首个出队的目标线路即最少换乘
+// 返回该目标线路，不可达返回 -1；路径通过 ws.prevLine / ws.prevStation 回溯
+int transferBfs(const BusNetwork& net, const int* sources, int sourceCount, const int* goals, int goalCount, TransferWorkspace& ws);
 
 // 计算最少换乘次数（BFS）
 // 参数：
-// L：线路数量
-// lineStations：每条线路的站点序列
-// stationLines：每个站点所属线路列表
-// inLine：inLine[l][sid] 表示站点 sid 是否在线路 l 上
+// net：公交网络索引
 // startSid / endSid：起止站点编号
-// nameOf：站点名称
-void solveMinTransfers(
-    int L,
-    const std::vector< std::vector<int> >& lineStations,
-    const std::vector< std::vector<int> >& stationLines,
-    const std::vector< std::vector<char> >& inLine,
+// ws：换乘 BFS 工作区
+// route：结果；返回是否可达
+bool solveMinTransfers(
+    const BusNetwork& net,
     int startSid,
     int endSid,
-    const std::vector<std::string>& nameOf
+    TransferWorkspace& ws,
+    BusRoute& route
 );
 
 // 综合最优：先最少换乘，再最少总站数（Dijkstra，字典序权重）
-// 参数同上，posInLine 提供站点在各线路中的位置索引
-void solveWeighted(
-    int L,
-    const std::vector< std::vector<int> >& lineStations,
-    const std::vector< std::vector<int> >& stationLines,
-    const std::vector< std::vector<int> >& posInLine,
+// 参数同上，ws 为综合最优搜索工作区
+bool solveWeighted(
+    const BusNetwork& net,
     int startSid,
     int endSid,
-    const std::vector<std::string>& nameOf
+    WeightedWorkspace& ws,
+    BusRoute& route
 );
 
+// 综合最优的搜索本体：起点站的各线路为源，按（换乘次数, 站数）字典序逐层扩展状态
+// 第一次取出终点站的状态即停止；endSid 为 -1 时不提前结束，搜索全部可达状态（一对多）
+// 结果留在 ws 中：ws.stamp[u] == ws.epoch 的状态 u 的 transfers/stops 为最优代价，prev 为前驱状态（起点为 -1）
+void weightedSearch(const BusNetwork& net, int startSid, int endSid, WeightedWorkspace& ws);
+
+// 按 type=1 / type=2 查询的格式输出结果（names：站点名表）
+void printMinTransfers(std::ostream& out, const BusRoute& route, const StationTable& names);
+void printWeighted(std::ostream& out, const BusRoute& route, const StationTable& names);
+
 #endif
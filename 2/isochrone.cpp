@@ -0,0 +1,88 @@
+#include "isochrone.h"
+#include <vector>
+#include <cstring>
+#include "../common/parallel.h"
+
+using namespace std;
+
+static const char ISOCHRONE_MAGIC[8] = { 'B', 'U', 'S', 'I', 'S', 'O', 0, 0 };
+static const unsigned ISOCHRONE_VERSION = 1;
+static const unsigned ISOCHRONE_ENDIAN = 0x01020304;    // 按本机字节序写入，读取时比较即可判断字节序
+
+// 记录头（固定 24 字节）
+struct IsochroneHeader {
+    char magic[8];
+    unsigned version;
+    unsigned endian;
+    int origin;
+    int S;
+};
+
+Isochrone::Isochrone() : origin(-1) {}
+
+void solveIsochrone(const BusNetwork& net, int originSid, WeightedWorkspace& ws, Isochrone& iso) {
+    int S = net.S;
+    iso.origin = originSid;
+    iso.transfers.assign(S, -1);
+    iso.stops.assign(S, -1);
+    iso.prevStation.assign(S, -1);
+    iso.transfers[originSid] = 0;
+    iso.stops[originSid] = 0;
+
+    weightedSearch(net, originSid, -1, ws);
+
+    // 各站点取其（线路, 最后一次出现位置）状态中字典序最小者；前一站为沿前驱回溯遇到的第一个不同站点（跳过同站换乘）
+    for (int sid = 0; sid < S; ++sid) {
+        if (sid == originSid) continue;
+        int best = -1;
+        for (int k = net.stationStart[sid]; k < net.stationStart[sid + 1]; ++k) {
+            int id = net.lineStart[net.stationLine[k]] + net.stationPos[k];
+            if (ws.stamp[id] != ws.epoch) continue;
+            if (best == -1 || ws.transfers[id] < ws.transfers[best] || (ws.transfers[id] == ws.transfers[best] && ws.stops[id] < ws.stops[best])) best = id;
+        }
+        if (best == -1) continue;
+        iso.transfers[sid] = ws.transfers[best];
+        iso.stops[sid] = ws.stops[best];
+        int p = ws.prev[best];
+        while (p != -1 && net.lineStop[p] == sid) p = ws.prev[p];
+        iso.prevStation[sid] = p == -1 ? -1 : net.lineStop[p];
+    }
+}
+
+void solveIsochrones(const BusNetwork& net, const vector<int>& origins, int threads, vector<Isochrone>& out) {
+    int n = (int)origins.size();
+    out.resize(n);
+    if (threads < 1) threads = 1;
+    vector<WeightedWorkspace> ws(threads);
+    parallelFor(n, threads, [&](int i, int tid) {
+        solveIsochrone(net, origins[i], ws[tid], out[i]);
+    });
+}
+
+void summarizeIsochrone(const Isochrone& iso, int& reached, int& maxTransfers, int& maxStops) {
+    reached = 0;
+    maxTransfers = 0;
+    maxStops = 0;
+    for (size_t i = 0; i < iso.transfers.size(); ++i) {
+        if (iso.transfers[i] < 0) continue;
+        ++reached;
+        if (iso.transfers[i] > maxTransfers) maxTransfers = iso.transfers[i];
+        if (iso.stops[i] > maxStops) maxStops = iso.stops[i];
+    }
+}
+
+static bool writeSection(FILE* f, const vector<int>& a) {
+    return a.empty() || fwrite(a.data(), sizeof(int), a.size(), f) == a.size();
+}
+
+bool writeIsochrone(FILE* f, const Isochrone& iso) {
+    IsochroneHeader h;
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, ISOCHRONE_MAGIC, sizeof(h.magic));
+    h.version = ISOCHRONE_VERSION;
+    h.endian = ISOCHRONE_ENDIAN;
+    h.origin = iso.origin;
+    h.S = (int)iso.transfers.size();
+    return fwrite(&h, sizeof(h), 1, f) == 1
+        && writeSection(f, iso.transfers) && writeSection(f, iso.stops) && writeSection(f, iso.prevStation);
+}
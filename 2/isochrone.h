@@ -0,0 +1,38 @@
+#ifndef ISOCHRONE_H
+#define ISOCHRONE_H
+
+// 一对多换乘等时圈：从一个起点站出发，一次综合最优搜索（不提前结束）得到到全部站点的最少（换乘次数, 站数）
+// 结果为按站点编号排列的三个数组，可写成二进制记录供覆盖图等离线分析使用
+// 多起点版本由 parallelFor 分给多个线程，每个线程持有自己的搜索工作区，网络只读共享
+
+#include <vector>
+#include <cstdio>
+#include "bus.h"
+
+// 一个起点的结果：下标为站点编号；不可达站点 transfers 与 stops 为 -1
+// prevStation 为最优路线上的前一站（起点与不可达站点为 -1）；各站的最优路线不一定以前一站的最优路线为前缀，
+// 因此前驱只用于画出最后一段，不保证沿前驱链回溯得到的仍是最优路线
+struct Isochrone {
+    int origin;
+    std::vector<int> transfers;
+    std::vector<int> stops;
+    std::vector<int> prevStation;
+    Isochrone();
+};
+
+// 单起点：一次搜索全部可达状态，再对每个站点取其各线路状态中字典序最小者
+void solveIsochrone(const BusNetwork& net, int originSid, WeightedWorkspace& ws, Isochrone& iso);
+
+// 多起点并行：out[i] 对应 origins[i]，threads 个线程各用自己的工作区
+void solveIsochrones(const BusNetwork& net, const std::vector<int>& origins, int threads, std::vector<Isochrone>& out);
+
+// 可达站点数与其中的最大换乘次数、最大站数（起点计入可达）
+void summarizeIsochrone(const Isochrone& iso, int& reached, int& maxTransfers, int& maxStops);
+
+// 追加一条二进制记录（按本机字节序）：
+//   记录头 24 字节：魔数 "BUSISO" + 2 字节 0、版本（uint32）、字节序标记 0x01020304（uint32）、起点（int32）、站点数 S（int32）
+//   随后 transfers、stops、prevStation 各 int32 × S
+// 写入失败返回 false
+bool writeIsochrone(std::FILE* f, const Isochrone& iso);
+
+#endif
@@ -1,112 +1,213 @@
 #include <iostream>
 #include <vector>
-#include <map>
 #include <string>
-#include <limits>
-#include <ctime>
+#include <memory>
+#include <sstream>
+#include <cstring>
+#include <cstdlib>
+#include <cstdio>
 #include "bus.h"
+#include "query_service.h"
+#include "../common/parallel.h"
+#include "../common/fast_input.h"
+#include "../common/perf_stats.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
 
 using namespace std;
 
-static int getStationId(map<string, int>& idOf, vector<string>& nameOf, const string& name) {
-    map<string, int>::iterator it = idOf.find(name);
-    if (it != idOf.end()) return it->second;
-    int id = (int)nameOf.size();
-    idOf[name] = id;
-    nameOf.push_back(name);
-    return id;
-}
+int main(int argc, char** argv) {
+    // --stats：每次查询后向标准错误输出一行 JSON 统计（计数需以 -DPERF_STATS 编译）
+    // --max-transfers k：type=3 RAPTOR 查询的最多换乘次数（默认 8，取值 0..MAX_RAPTOR_TRANSFERS）
+    // --threads k：线程数（默认硬件并发数），用于换乘表构建与批量、套接字模式的工作线程
+    // --batch：先读入全部查询，由 --threads 个线程并行回答，再按原始顺序输出
+    // --isochrone-out 文件：type=8 一对多查询的各站点结果按查询顺序写成二进制记录（格式见 isochrone.h）
+    // --socket 路径：回答完标准输入中的查询后，在 Unix 域套接字上继续提供查询服务（--threads 个工作线程）
+    bool stats = false;
+    bool batch = false;
+    const char* socketPath = 0;
+    const char* isochroneFile = 0;
+    int maxTransfers = 8;
+    int threads = defaultThreadCount();
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) stats = true;
+        else if (strcmp(argv[i], "--batch") == 0) batch = true;
+        else if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) socketPath = argv[++i];
+        else if (strcmp(argv[i], "--isochrone-out") == 0 && i + 1 < argc) isochroneFile = argv[++i];
+        else if (strcmp(argv[i], "--max-transfers") == 0 && i + 1 < argc) {
+            // strtol 超出 long 范围时饱和，不会像 atoi 那样未定义；再折回 int 前先按上限截断
+            long v = strtol(argv[++i], 0, 10);
+            maxTransfers = v < -1 ? -1 : (v > MAX_RAPTOR_TRANSFERS + 1 ? MAX_RAPTOR_TRANSFERS + 1 : (int)v);
+        }
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) threads = atoi(argv[++i]);
+    }
+    // 轮数决定每次查询的标签表大小（(k+1) 行 × 站点数），负数或过大的值直接拒绝
+    if (maxTransfers < 0 || maxTransfers > MAX_RAPTOR_TRANSFERS) {
+        cout << "--max-transfers 取值应为 0.." << MAX_RAPTOR_TRANSFERS << "\n";
+        return 1;
+    }
 
-int main() {
     ios::sync_with_stdio(false);
-    cin.tie(0);
     #ifdef _WIN32
     SetConsoleOutputCP(65001);
     #endif
 
+    // 输入统一经 FastInput 读取：重定向自文件时整体映射，否则按块读入
+    FastInput in;
+    in.openStdin();
+
     int L;
-    if (!(cin >> L)) {
+    if (!in.readInt(L)) {
         cout << "输入格式:\n";
         cout << "L\n";
         cout << "每条线路：k 站点1 ... 站点k\n";
         cout << "Q\n";
-        cout << "Q 行查询: type 起点站 终点站  (type=1 最少换乘, type=2 综合最优)\n";
+        cout << "Q 行查询: type 起点站 终点站  (type=1 最少换乘, type=2 综合最优, type=3 RAPTOR 各换乘次数的 Pareto 方案, type=4 查表求最少换乘次数)\n";
+        cout << "          或一对多: 8 起点站 (到全部站点的最少换乘次数与站数)\n";
+        cout << "          或线路变更: 5 k 站点1 ... 站点k (新增线路), 6 线路编号 (删除线路), 7 线路编号 k 站点1 ... 站点k (替换站点序列)\n";
+        cout << "可选参数: --stats (每次查询向标准错误输出 JSON 统计, 计数需 -DPERF_STATS 编译)\n";
+        cout << "          --max-transfers k (type=3 最多换乘次数, 0.." << MAX_RAPTOR_TRANSFERS << ", 默认 8)\n";
+        cout << "          --threads k (线程数: 换乘表构建、批量与套接字模式的工作线程)\n";
+        cout << "          --batch (读入全部查询后并行回答), --socket 路径 (在 Unix 域套接字上提供查询服务)\n";
+        cout << "          --isochrone-out 文件 (type=8 结果写成二进制记录)\n";
         return 0;
     }
 
-    map<string, int> stationId;
-    vector<string> nameOf;
+    // 网络加载完成后作为版本 1 发布，此后只读；线路变更发布新版本
+    BusVersions versions;
+    shared_ptr<StationTable> names = make_shared<StationTable>();
+    shared_ptr<BusSnapshot> first = make_shared<BusSnapshot>();
+    first->maxTransfers = maxTransfers;
 
     vector< vector<int> > lineStations(L + 1);
     for (int i = 1; i <= L; ++i) {
-        int k;
-        cin >> k;
+        int k = 0;
+        in.readInt(k);
         lineStations[i].resize(k);
         for (int j = 0; j < k; ++j) {
-            string s;
-            cin >> s;
-            int sid = getStationId(stationId, nameOf, s);
+            string_view s;
+            in.readToken(s);
+            int sid = names->intern(s);
             lineStations[i][j] = sid;
         }
     }
 
-    int S = (int)nameOf.size();
-    vector< vector<int> > stationLines(S);
-    for (int i = 1; i <= L; ++i) {
-        for (size_t j = 0; j < lineStations[i].size(); ++j) {
-            int sid = lineStations[i][j];
-            stationLines[sid].push_back(i);
-        }
-    }
+    // 构建紧凑的线路/站点索引后，逐线路的站点序列即可释放
+    int S = names->size();
+    buildBusNetwork(S, lineStations, first->net);
+    vector< vector<int> >().swap(lineStations);
+    first->names = names;
+    publishSnapshot(versions, first);
+    first.reset();
+    names.reset();
 
-    vector< vector<char> > inLine(L + 1, vector<char>(S, 0));
-    for (int i = 1; i <= L; ++i) {
-        for (size_t j = 0; j < lineStations[i].size(); ++j) {
-            inLine[i][lineStations[i][j]] = 1;
-        }
+    if (stats && !perfStatsCompiled()) cerr << "统计计数未编译（需 -DPERF_STATS），仅输出耗时\n";
+
+    FILE* isoOut = 0;
+    if (isochroneFile) {
+        isoOut = fopen(isochroneFile, "wb");
+        if (!isoOut) cerr << "无法写出: " << isochroneFile << "\n";
     }
+    // 一对多结果按查询顺序写出
+    auto emitIsochrone = [&](const BusAnswer& a) {
+        if (isoOut && a.iso.origin != -1 && !writeIsochrone(isoOut, a.iso)) {
+            cerr << "写出一对多结果失败: " << isochroneFile << "\n";
+            fclose(isoOut);
+            isoOut = 0;
+        }
+    };
 
-    vector< vector<int> > posInLine(L + 1, vector<int>(S, -1));
-    for (int i = 1; i <= L; ++i) {
-        for (size_t j = 0; j < lineStations[i].size(); ++j) {
-            posInLine[i][lineStations[i][j]] = (int)j;
+    shared_ptr<const BusSnapshot> cached;
+    unsigned long long cachedPublished = 0;
+    QueryScratch scratch;
+    BusAnswer ans;
+    // 批量模式下待回答的查询：遇到线路变更或读完时一起并行回答
+    vector<BusQuery> pending;
+    int pendingFirst = 0;
+    vector<BusAnswer> answers;
+    auto flushPending = [&]() {
+        if (pending.empty()) return;
+        const BusSnapshot* snap = &acquireSnapshot(versions, cached, cachedPublished);
+        // 换乘表先于并行执行构建，预处理信息仍输出在首个 type=4 回答之前
+        int firstTableQuery = -1;
+        for (size_t i = 0; i < pending.size() && firstTableQuery == -1; ++i) {
+            if (pending[i].type == 4 && stationsServed(*snap, pending[i])) firstTableQuery = (int)i;
         }
-    }
+        ostringstream tableInfo;
+        if (firstTableQuery != -1 && !snap->tableReady) {
+            ensureTransferTable(versions, threads, tableInfo);
+            snap = &acquireSnapshot(versions, cached, cachedPublished);
+        }
+        runBusQueries(*snap, pending, pendingFirst + 1, threads, stats, answers);
+        for (size_t i = 0; i < pending.size(); ++i) {
+            if ((int)i == firstTableQuery) cout << tableInfo.str();
+            cout << answers[i].reply;
+            if (stats) cerr << answers[i].stats;
+            emitIsochrone(answers[i]);
+        }
+        pending.clear();
+    };
 
-    int Q;
-    cin >> Q;
+    int Q = 0;
+    in.readInt(Q);
     for (int qi = 0; qi < Q; ++qi) {
-        int type;
-        string startName, endName;
-        cin >> type >> startName >> endName;
-
-        if (stationId.find(startName) == stationId.end() || stationId.find(endName) == stationId.end()) {
-            cout << "无可达路线\n";
+        int type = 0;
+        in.readInt(type);
+        if (type >= 5 && type <= 7) {
+            // 线路变更：5 k 站点1..k 新增 / 6 线路 删除 / 7 线路 k 站点1..k 替换
+            int line = 0, k = 0;
+            if (type != 5) {
+                in.readInt(line);
+                if (line < 1) line = -1;
+            }
+            if (type != 6) in.readInt(k);
+            vector<string> stationNames(k > 0 ? k : 0);
+            for (int j = 0; j < k; ++j) {
+                string_view name;
+                in.readToken(name);
+                stationNames[j] = string(name);
+            }
+            vector<string_view> views(stationNames.begin(), stationNames.end());
+            flushPending();
+            cout << applyLineUpdate(versions, line, views);
             continue;
         }
 
-        int startSid = stationId[startName];
-        int endSid = stationId[endName];
-
-        if (stationLines[startSid].empty() || stationLines[endSid].empty()) {
-            cout << "无可达路线\n";
+        // 起点名的视图在读下一个词元后失效，先查出编号
+        const BusSnapshot* snap = &acquireSnapshot(versions, cached, cachedPublished);
+        BusQuery q;
+        q.type = type;
+        string_view name;
+        in.readToken(name);
+        q.startSid = findStation(*snap, name);
+        if (type != 8) {
+            in.readToken(name);
+            q.endSid = findStation(*snap, name);
+        }
+        if (batch) {
+            if (pending.empty()) pendingFirst = qi;
+            pending.push_back(q);
             continue;
         }
 
-        if (type == 1) {
-            clock_t st = clock();
-            solveMinTransfers(L, lineStations, stationLines, inLine, startSid, endSid, nameOf);
-            clock_t ed = clock();
-            cout << "耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
-        } else {
-            clock_t st = clock();
-            solveWeighted(L, lineStations, stationLines, posInLine, startSid, endSid, nameOf);
-            clock_t ed = clock();
-            cout << "耗时(毫秒): " << (1000.0 * (double)(ed - st) / (double)CLOCKS_PER_SEC) << "\n";
+        // 逐条模式：换乘表在首次 type=4 查询时构建，线路变更后的首次 type=4 查询前重建
+        if (q.type == 4 && !snap->tableReady && stationsServed(*snap, q)) {
+            ensureTransferTable(versions, threads, cout);
+            snap = &acquireSnapshot(versions, cached, cachedPublished);
         }
+        answerQuery(*snap, q, qi + 1, stats, scratch, ans);
+        cout << ans.reply;
+        if (stats) cerr << ans.stats;
+        emitIsochrone(ans);
+    }
+    flushPending();
+    if (isoOut && fclose(isoOut) != 0) cerr << "写出一对多结果失败: " << isochroneFile << "\n";
+
+    if (socketPath) {
+        ensureTransferTable(versions, threads, cout);
+        cout << "查询服务: " << socketPath << ", 工作线程数: " << (threads < 1 ? 1 : threads) << endl;
+        return serveUnixSocket(versions, socketPath, threads, stats) == 0 ? 0 : 1;
     }
 
     return 0;
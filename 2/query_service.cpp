@@ -0,0 +1,508 @@
+#include "query_service.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <thread>
+#include <atomic>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <charconv>
+#include <cstring>
+#include "../common/parallel.h"
+#include "../common/perf_stats.h"
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <csignal>
+#include <cerrno>
+#endif
+
+using namespace std;
+
+BusSnapshot::BusSnapshot() : version(1), tableReady(false), maxTransfers(8) {}
+
+BusVersions::BusVersions() : published(0) {}
+
+BusQuery::BusQuery() : type(0), startSid(-1), endSid(-1) {}
+
+int findStation(const BusSnapshot& snap, string_view name) {
+    return snap.names->find(name);
+}
+
+void publishSnapshot(BusVersions& versions, shared_ptr<const BusSnapshot> snap) {
+    atomic_store(&versions.current, snap);
+    versions.published.fetch_add(1, memory_order_release);
+}
+
+const BusSnapshot& acquireSnapshot(const BusVersions& versions, shared_ptr<const BusSnapshot>& cached, unsigned long long& cachedPublished) {
+    // 先读发布次数再取指针：读到新的次数时 current 必已替换
+    unsigned long long p = versions.published.load(memory_order_acquire);
+    if (!cached || p != cachedPublished) {
+        cached = atomic_load(&versions.current);
+        cachedPublished = p;
+    }
+    return *cached;
+}
+
+// 构建换乘表并输出预处理信息
+static void buildTable(BusSnapshot& snap, int threads, ostream& out) {
+    PerfTimer timer;
+    size_t bytes = buildTransferTable(snap.net, threads, snap.table);
+    double ms = timer.elapsedMs();
+    snap.tableReady = true;
+    out << "换乘表预处理 耗时(毫秒): " << ms
+        << ", 表大小(字节): " << snap.table.cells.size() << ", 构建峰值内存(字节): " << bytes << "\n";
+}
+
+void ensureTransferTable(BusVersions& versions, int threads, ostream& out) {
+    lock_guard<mutex> guard(versions.writeLock);
+    shared_ptr<const BusSnapshot> cur = atomic_load(&versions.current);
+    if (cur->tableReady) return;
+    shared_ptr<BusSnapshot> next = make_shared<BusSnapshot>(*cur);
+    buildTable(*next, threads, out);
+    publishSnapshot(versions, next);
+}
+
+bool refreshTransferTable(BusVersions& versions, int threads) {
+    shared_ptr<const BusSnapshot> cur = atomic_load(&versions.current);
+    if (cur->tableReady) return false;
+    shared_ptr<BusSnapshot> next = make_shared<BusSnapshot>(*cur);
+    buildTransferTable(next->net, threads, next->table);
+    next->tableReady = true;
+    lock_guard<mutex> guard(versions.writeLock);
+    // 构建期间又有变更发布时放弃，由那次变更之后的补建负责
+    if (atomic_load(&versions.current) != cur) return false;
+    publishSnapshot(versions, next);
+    return true;
+}
+
+string applyLineUpdate(BusVersions& versions, int line, const vector<string_view>& stations) {
+    lock_guard<mutex> guard(versions.writeLock);
+    shared_ptr<const BusSnapshot> cur = atomic_load(&versions.current);
+    if (line < 0 || line > cur->net.L) return "线路编号无效\n";
+
+    PerfTimer timer;
+    // 只有出现新站点时才复制站点名表
+    shared_ptr<StationTable> grown;
+    vector<LineDelta> deltas(1);
+    deltas[0].line = line;
+    for (size_t i = 0; i < stations.size(); ++i) {
+        int sid = grown ? grown->intern(stations[i]) : findStation(*cur, stations[i]);
+        if (sid == -1) {
+            grown = make_shared<StationTable>(*cur->names);
+            sid = grown->intern(stations[i]);
+        }
+        deltas[0].stations.push_back(sid);
+    }
+    shared_ptr<BusSnapshot> next = make_shared<BusSnapshot>();
+    if (grown) next->names = grown;
+    else next->names = cur->names;
+    applyLineDeltas(cur->net, next->names->size(), deltas, next->net);
+    next->version = cur->version + 1;
+    next->maxTransfers = cur->maxTransfers;
+    // 换乘表随网络整体变化，不在写锁内重建：新版本先不带表发布（type=4 回退到 BFS），由 refreshTransferTable 补建
+    double ms = timer.elapsedMs();
+    publishSnapshot(versions, next);
+
+    ostringstream out;
+    out << "线路 L" << (line == 0 ? next->net.L : line) << (line == 0 ? " 已添加" : (stations.empty() ? " 已删除" : " 已更新"))
+        << ", 网络版本: " << next->version << ", 耗时(毫秒): " << ms << "\n";
+    return out.str();
+}
+
+bool stationsServed(const BusSnapshot& snap, const BusQuery& q) {
+    const BusNetwork& net = snap.net;
+    if (q.startSid < 0 || q.endSid < 0) return false;
+    return net.stationStart[q.startSid] != net.stationStart[q.startSid + 1] && net.stationStart[q.endSid] != net.stationStart[q.endSid + 1];
+}
+
+static const char* solverName(int type) {
+    if (type == 8) return "isochrone";
+    return type == 1 ? "min_transfers" : (type == 3 ? "raptor" : (type == 4 ? "transfer_table" : "weighted"));
+}
+
+// type=4：查表；表未构建或计数饱和时回退到 BFS，不可达返回 -1
+static int countTransfers(const BusSnapshot& snap, int startSid, int endSid, TransferWorkspace& ws) {
+    const BusNetwork& net = snap.net;
+    int transfers = snap.tableReady ? stationTransfers(net, snap.table, startSid, endSid) : TRANSFER_SATURATED;
+    if (transfers == TRANSFER_SATURATED) {
+        const int* lines = &net.stationLine[0];
+        int goal = transferBfs(net,
+            lines + net.stationStart[startSid], net.stationStart[startSid + 1] - net.stationStart[startSid],
+            lines + net.stationStart[endSid], net.stationStart[endSid + 1] - net.stationStart[endSid], ws);
+        transfers = goal == -1 ? -1 : ws.dist[goal];
+    }
+    return transfers;
+}
+
+void answerQuery(const BusSnapshot& snap, const BusQuery& q, long long index, bool stats, QueryScratch& scratch, BusAnswer& ans) {
+    ans.stats.clear();
+    ans.iso.origin = -1;
+    if (q.type == 8 ? q.startSid < 0 : !stationsServed(snap, q)) {
+        ans.reply = "无可达路线\n";
+        return;
+    }
+
+    ostringstream& out = scratch.out;
+    out.str(string());
+    perfReset();
+    PerfTimer timer;
+    double ms = 0.0;
+    if (q.type == 8) {
+        solveIsochrone(snap.net, q.startSid, scratch.weightedWs, ans.iso);
+        ms = timer.elapsedMs();
+        int reached = 0, maxTransfers = 0, maxStops = 0;
+        summarizeIsochrone(ans.iso, reached, maxTransfers, maxStops);
+        out << "一对多: 可达站点数 " << reached << " / " << snap.net.S << ", 最多换乘 " << maxTransfers << " 次, 最多 " << maxStops << " 站\n";
+    } else if (q.type == 1) {
+        solveMinTransfers(snap.net, q.startSid, q.endSid, scratch.transferWs, scratch.route);
+        ms = timer.elapsedMs();
+        printMinTransfers(out, scratch.route, *snap.names);
+    } else if (q.type == 4) {
+        int transfers = countTransfers(snap, q.startSid, q.endSid, scratch.transferWs);
+        ms = timer.elapsedMs();
+        if (transfers < 0) out << "无可达路线\n";
+        else out << "最少换乘次数: " << transfers << "\n";
+    } else if (q.type == 3) {
+        raptorSearch(snap.net, q.startSid, q.endSid, snap.maxTransfers, scratch.raptorWs, scratch.journeys);
+        ms = timer.elapsedMs();
+        printRaptor(out, scratch.journeys, snap.maxTransfers, *snap.names);
+    } else {
+        solveWeighted(snap.net, q.startSid, q.endSid, scratch.weightedWs, scratch.route);
+        ms = timer.elapsedMs();
+        printWeighted(out, scratch.route, *snap.names);
+    }
+    out << "耗时(毫秒): " << ms << "\n";
+    ans.reply = out.str();
+    if (stats) {
+        ostringstream js;
+        perfWriteJson(js, "bus", index, solverName(q.type), ms);
+        ans.stats = js.str();
+    }
+}
+
+void runBusQueries(const BusSnapshot& snap, const vector<BusQuery>& queries, long long firstIndex, int threads, bool stats, vector<BusAnswer>& answers) {
+    int q = (int)queries.size();
+    answers.assign(q, BusAnswer());
+    if (threads < 1) threads = 1;
+    vector<QueryScratch> scratch(threads);
+    parallelFor(q, threads, [&](int i, int tid) {
+        answerQuery(snap, queries[i], firstIndex + i, stats, scratch[tid], answers[i]);
+    });
+}
+
+// 按空白切分一行请求
+static void splitTokens(string_view line, vector<string_view>& tok) {
+    tok.clear();
+    size_t i = 0;
+    while (i < line.size()) {
+        while (i < line.size() && (line[i] == ' ' || line[i] == '\t' || line[i] == '\r')) ++i;
+        if (i == line.size()) break;
+        size_t j = i;
+        while (j < line.size() && line[j] != ' ' && line[j] != '\t' && line[j] != '\r') ++j;
+        tok.push_back(line.substr(i, j - i));
+        i = j;
+    }
+}
+
+static bool parseInt(string_view tok, int& x) {
+    from_chars_result r = from_chars(tok.data(), tok.data() + tok.size(), x);
+    return r.ec == errc() && r.ptr == tok.data() + tok.size();
+}
+
+// 线路变更请求：5 k 站点1..k / 6 线路 / 7 线路 k 站点1..k；格式错误返回 false
+static bool parseLineUpdate(const vector<string_view>& tok, int type, int& line, vector<string_view>& stations) {
+    int k = 0;
+    size_t first = 0;
+    line = 0;
+    if (type == 6) {
+        if (tok.size() != 2 || !parseInt(tok[1], line)) return false;
+        first = 2;
+    } else if (type == 5) {
+        if (tok.size() < 2 || !parseInt(tok[1], k)) return false;
+        first = 2;
+    } else {
+        if (tok.size() < 3 || !parseInt(tok[1], line) || !parseInt(tok[2], k)) return false;
+        first = 3;
+    }
+    if (k < 0 || tok.size() != first + (size_t)k) return false;
+    if (type != 5 && line < 1) line = -1;
+    stations.assign(tok.begin() + first, tok.end());
+    return true;
+}
+
+#ifndef _WIN32
+// 写出全部数据；对端已关闭时返回 false
+static bool writeAll(int fd, const string& data) {
+    size_t done = 0;
+    while (done < data.size()) {
+        ssize_t n = ::write(fd, data.data() + done, data.size() - done);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        done += (size_t)n;
+    }
+    return true;
+}
+
+// 单行请求的长度上限（字节）：一直不发换行的客户端不能让缓冲无限增长；超过时回复错误并关闭连接
+static const size_t MAX_REQUEST_BYTES = 1 << 20;
+// 请求行过长的标记：正常的请求行按换行切分，不含换行符
+static const char TOO_LONG_MARK[] = "\n";
+
+// 一个连接：buf 为尚未成行的数据（只由 I/O 线程访问）；其余字段由 mu 保护
+// 同一连接同一时刻至多一条请求在工作线程上（busy），因此回答顺序与请求顺序一致
+struct SocketConn {
+    int fd;
+    string buf;
+    deque<string> lines;    // 已收到、待回答的请求行
+    size_t pendingBytes;    // lines 的总字节数，超过上限时暂停读取（背压）
+    bool busy;
+    bool eof;    // 对端已关闭或请求过长：不再读取，回答完已排队的请求后关闭
+    bool dead;    // 写出失败：丢弃其余请求
+    explicit SocketConn(int f) : fd(f), pendingBytes(0), busy(false), eof(false), dead(false) {}
+};
+
+// 工作线程私有的状态，跨请求复用
+struct SocketWorker {
+    QueryScratch scratch;
+    shared_ptr<const BusSnapshot> cached;
+    unsigned long long cachedPublished;
+    BusAnswer ans;
+    vector<string_view> tok, stations;
+    bool refreshTable;    // 本线程发布了线路变更：写出回答后为新版本补建换乘表
+    SocketWorker() : cachedPublished(0), refreshTable(false) {}
+};
+
+// 回答一行请求，回答文本（以空行结束）追加到 reply；空白行不回答
+// 每条查询使用收到时的当前版本（w.cached 为本线程缓存的版本）
+static void answerRequest(BusVersions& versions, const string& line, bool stats, atomic<long long>& served, SocketWorker& w, string& reply) {
+    if (line == TOO_LONG_MARK) {
+        reply += "请求过长（上限 " + to_string(MAX_REQUEST_BYTES) + " 字节），连接关闭\n\n";
+        return;
+    }
+    splitTokens(line, w.tok);
+    if (w.tok.empty()) return;
+    const vector<string_view>& tok = w.tok;
+    BusQuery q;
+    bool ok = parseInt(tok[0], q.type);
+    if (ok && q.type >= 5 && q.type <= 7) {
+        int lineId = 0;
+        ok = parseLineUpdate(tok, q.type, lineId, w.stations);
+        if (ok) {
+            reply += applyLineUpdate(versions, lineId, w.stations);
+            reply += "\n";
+            w.refreshTable = true;
+        }
+    } else if (ok && tok.size() == (q.type == 8 ? 2u : 3u)) {
+        const BusSnapshot& snap = acquireSnapshot(versions, w.cached, w.cachedPublished);
+        q.startSid = findStation(snap, tok[1]);
+        if (q.type != 8) q.endSid = findStation(snap, tok[2]);
+        long long index = stats ? served.fetch_add(1) + 1 : 0;
+        answerQuery(snap, q, index, stats, w.scratch, w.ans);
+        reply += w.ans.reply;
+        reply += "\n";
+        if (stats && !w.ans.stats.empty()) cerr.write(w.ans.stats.data(), (streamsize)w.ans.stats.size());
+    } else {
+        ok = false;
+    }
+    if (!ok) reply += "请求格式: type 起点站 终点站，8 起点站（一对多），或线路变更 5 k 站点... / 6 线路 / 7 线路 k 站点...\n\n";
+}
+
+// 把 I/O 线程从 poll 中唤醒（写端非阻塞，管道已满时说明已有未处理的唤醒）
+static void wakeUp(int fd) {
+    char b = 1;
+    ssize_t n = ::write(fd, &b, 1);
+    (void)n;
+}
+#endif
+
+int serveUnixSocket(BusVersions& versions, const char* path, int threads, bool stats) {
+#ifdef _WIN32
+    (void)versions; (void)path; (void)threads; (void)stats;
+    cerr << "当前平台不支持 Unix 域套接字\n";
+    return -1;
+#else
+    sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        cerr << "套接字路径过长: " << path << "\n";
+        return -1;
+    }
+    strcpy(addr.sun_path, path);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0) {
+        cerr << "无法创建套接字: " << strerror(errno) << "\n";
+        return -1;
+    }
+    ::unlink(path);
+    if (bind(fd, (sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+        cerr << "无法监听 " << path << ": " << strerror(errno) << "\n";
+        ::close(fd);
+        return -1;
+    }
+    // 客户端提前断开时 write 返回错误，而不是以 SIGPIPE 结束进程
+    signal(SIGPIPE, SIG_IGN);
+
+    if (threads < 1) threads = 1;
+    int wake[2];
+    if (pipe(wake) < 0) {
+        cerr << "无法创建管道: " << strerror(errno) << "\n";
+        ::close(fd);
+        return -1;
+    }
+    fcntl(wake[0], F_SETFL, O_NONBLOCK);
+    fcntl(wake[1], F_SETFL, O_NONBLOCK);
+
+    // 工作线程：每次从就绪队列取一个连接，回答它的下一条请求；连接还有请求时排回队尾，各连接轮流得到服务
+    mutex mu;
+    condition_variable cv;
+    deque<SocketConn*> ready;
+    bool stopping = false;
+    atomic<long long> served(0);
+    vector<thread> pool;
+    for (int tid = 0; tid < threads; ++tid) {
+        pool.push_back(thread([&]() {
+            SocketWorker w;
+            string line, reply;
+            for (;;) {
+                SocketConn* c;
+                {
+                    unique_lock<mutex> lk(mu);
+                    cv.wait(lk, [&]() { return stopping || !ready.empty(); });
+                    if (ready.empty()) return;
+                    c = ready.front();
+                    ready.pop_front();
+                    line.swap(c->lines.front());
+                    c->lines.pop_front();
+                    c->pendingBytes -= line.size();
+                }
+                reply.clear();
+                answerRequest(versions, line, stats, served, w, reply);
+                bool ok = reply.empty() || writeAll(c->fd, reply);
+                bool notify, more;
+                {
+                    lock_guard<mutex> lk(mu);
+                    if (!ok) {
+                        c->dead = true;
+                        c->lines.clear();
+                        c->pendingBytes = 0;
+                    }
+                    more = !c->lines.empty();
+                    if (more) ready.push_back(c);
+                    else c->busy = false;
+                    // 连接可以关闭，或积压降到上限以下需要恢复读取时，唤醒 I/O 线程
+                    notify = (!c->busy && (c->eof || c->dead)) || c->pendingBytes + line.size() >= MAX_REQUEST_BYTES;
+                }
+                if (more) cv.notify_one();
+                if (notify) wakeUp(wake[1]);
+                // 连接已交还后再补建，构建期间其他请求（包括同一连接的后续请求）照常由其他线程回答
+                if (w.refreshTable) {
+                    w.refreshTable = false;
+                    refreshTransferTable(versions, threads);
+                }
+            }
+        }));
+    }
+
+    // I/O 线程（调用者）：poll 监听套接字与全部连接，读入数据、切分请求行并交给工作线程；连接只由本线程关闭
+    vector< unique_ptr<SocketConn> > conns;
+    vector<pollfd> fds;
+    char chunk[4096];
+    for (;;) {
+        fds.clear();
+        pollfd lp = { fd, POLLIN, 0 };
+        pollfd wp = { wake[0], POLLIN, 0 };
+        fds.push_back(lp);
+        fds.push_back(wp);
+        {
+            lock_guard<mutex> lk(mu);
+            size_t keep = 0;
+            for (size_t k = 0; k < conns.size(); ++k) {
+                SocketConn* c = conns[k].get();
+                if (!c->busy && (c->dead || (c->eof && c->lines.empty()))) {
+                    ::close(c->fd);
+                    conns[k].reset();
+                    continue;
+                }
+                conns[keep++].swap(conns[k]);
+            }
+            conns.resize(keep);
+            for (size_t k = 0; k < conns.size(); ++k) {
+                SocketConn* c = conns[k].get();
+                // 不需要读取的连接以 -1 占位，poll 忽略它（否则对端关闭后会反复报告 POLLHUP）
+                bool readable = !c->eof && !c->dead && c->pendingBytes < MAX_REQUEST_BYTES;
+                pollfd cp = { readable ? c->fd : -1, POLLIN, 0 };
+                fds.push_back(cp);
+            }
+        }
+        int r = poll(&fds[0], (nfds_t)fds.size(), -1);
+        if (r < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        if (fds[1].revents) {
+            while (::read(wake[0], chunk, sizeof(chunk)) > 0) {}
+        }
+        for (size_t k = 2; k < fds.size(); ++k) {
+            if (fds[k].fd < 0 || !fds[k].revents) continue;
+            SocketConn* c = conns[k - 2].get();
+            ssize_t n = ::read(c->fd, chunk, sizeof(chunk));
+            if (n < 0 && (errno == EINTR || errno == EAGAIN)) continue;
+            vector<string> got;
+            bool closeRead = n <= 0;
+            if (n > 0) {
+                c->buf.append(chunk, (size_t)n);
+                size_t start = 0, nl;
+                while ((nl = c->buf.find('\n', start)) != string::npos) {
+                    if (nl - start > MAX_REQUEST_BYTES) break;
+                    got.push_back(c->buf.substr(start, nl - start));
+                    start = nl + 1;
+                }
+                c->buf.erase(0, start);
+                if (c->buf.size() > MAX_REQUEST_BYTES) {
+                    got.push_back(TOO_LONG_MARK);
+                    string().swap(c->buf);
+                    closeRead = true;
+                }
+            }
+            lock_guard<mutex> lk(mu);
+            if (closeRead) c->eof = true;
+            for (size_t j = 0; j < got.size(); ++j) {
+                c->pendingBytes += got[j].size();
+                c->lines.push_back(string());
+                c->lines.back().swap(got[j]);
+            }
+            if (!c->busy && !c->lines.empty() && !c->dead) {
+                c->busy = true;
+                ready.push_back(c);
+                cv.notify_one();
+            }
+        }
+        if (fds[0].revents) {
+            int c = accept(fd, 0, 0);
+            if (c >= 0) conns.push_back(unique_ptr<SocketConn>(new SocketConn(c)));
+            else if (errno != EINTR && errno != ECONNABORTED && errno != EAGAIN) break;
+        }
+    }
+
+    {
+        lock_guard<mutex> lk(mu);
+        stopping = true;
+        ready.clear();
+    }
+    cv.notify_all();
+    for (size_t k = 0; k < pool.size(); ++k) pool[k].join();
+    for (size_t k = 0; k < conns.size(); ++k) ::close(conns[k]->fd);
+    ::close(wake[0]);
+    ::close(wake[1]);
+    ::close(fd);
+    ::unlink(path);
+    return 0;
+#endif
+}
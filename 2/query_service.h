@@ -0,0 +1,106 @@
+#ifndef QUERY_SERVICE_H
+#define QUERY_SERVICE_H
+
+// 查询服务模块：网络加载后作为只读快照在多个工作线程间共享
+// 每个工作线程持有自己的 QueryScratch（各求解器的工作区与输出缓冲），查询之间不加锁
+// 线路变更不修改已发布的快照：写者在旧版本的基础上增量构建新版本，再原子地替换当前版本（RCU 方式）；
+// 进行中的查询继续使用自己持有的旧版本，旧版本在最后一个持有者放下后释放
+// 批量模式：先读入全部查询，由 parallelFor 动态分给各线程，回答按原始顺序保存
+// 套接字模式（Unix 域套接字）：一个 I/O 线程 poll 全部连接并切分请求行，按请求（而不是按连接）交给工作线程
+
+#include <vector>
+#include <string>
+#include <sstream>
+#include <string_view>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include "bus.h"
+#include "raptor.h"
+#include "transfer_table.h"
+#include "station_table.h"
+#include "isochrone.h"
+
+// 只读快照：发布后不再修改
+struct BusSnapshot {
+    unsigned long long version;    // 网络版本号，加载时为 1，每次线路变更加 1
+    BusNetwork net;
+    std::shared_ptr<const StationTable> names;    // 站点名表只增不减，没有新增站点的版本之间共享同一份
+    TransferTable table;
+    bool tableReady;    // 换乘表是否已构建；未构建时 type=4 查询改用 BFS
+    int maxTransfers;    // type=3 查询的最多换乘次数
+    BusSnapshot();
+};
+
+// 当前版本的发布点：current 只通过 std::atomic_load / std::atomic_store 访问，published 为发布次数
+// 写者（线路变更、补建换乘表）之间由 writeLock 互斥；读者不取锁，只在 published 变化时重新取得 current
+struct BusVersions {
+    std::shared_ptr<const BusSnapshot> current;
+    std::atomic<unsigned long long> published;
+    std::mutex writeLock;
+    BusVersions();
+};
+
+// 一条查询：站点不存在时编号为 -1；type=8（一对多）只有起点站
+struct BusQuery {
+    int type;
+    int startSid;
+    int endSid;
+    BusQuery();
+};
+
+// 一条查询的回答：reply 为输出文本（格式与逐条模式一致），stats 为 --stats 的 JSON 行（可为空）
+// type=8（一对多）时 iso 为各站点的结果，供调用方按查询顺序写成二进制记录；其他查询 iso.origin 为 -1
+struct BusAnswer {
+    std::string reply;
+    std::string stats;
+    Isochrone iso;
+};
+
+// 工作线程私有的查询空间，跨查询复用
+struct QueryScratch {
+    TransferWorkspace transferWs;
+    WeightedWorkspace weightedWs;
+    RaptorWorkspace raptorWs;
+    BusRoute route;
+    std::vector<RaptorJourney> journeys;
+    std::ostringstream out;
+};
+
+// 站点名查编号，不存在返回 -1
+int findStation(const BusSnapshot& snap, std::string_view name);
+
+// 发布新版本（调用方持有 writeLock，或尚无其他线程访问 versions）
+void publishSnapshot(BusVersions& versions, std::shared_ptr<const BusSnapshot> snap);
+
+// 读者取当前版本：cached 为调用方缓存的版本，发布次数未变时直接复用（只读一次原子变量）
+const BusSnapshot& acquireSnapshot(const BusVersions& versions, std::shared_ptr<const BusSnapshot>& cached, unsigned long long& cachedPublished);
+
+// 当前版本没有换乘表时补建并以新快照发布（网络不变、版本号不变），预处理信息写到 out
+void ensureTransferTable(BusVersions& versions, int threads, std::ostream& out);
+
+// 在写锁之外为当前版本补建换乘表（threads 个线程），完成后只在这期间没有新版本发布时发布；返回是否发布
+// 构建期间读者与线路变更都不受阻塞
+bool refreshTransferTable(BusVersions& versions, int threads);
+
+// 线路变更（type=5 新增 / 6 删除 / 7 替换）：line 为 0 表示新增，stations 为空表示删除
+// 增量构建新版本并发布，写锁只覆盖增量构建；新版本不带换乘表（type=4 回退到 BFS），需要时由调用方补建；返回回答文本
+std::string applyLineUpdate(BusVersions& versions, int line, const std::vector<std::string_view>& stations);
+
+// 起止站点都存在且都有线路经过
+bool stationsServed(const BusSnapshot& snap, const BusQuery& q);
+
+// 回答一条查询（index 为 JSON 中的查询序号）；只读 snap，只写 scratch 与 ans
+void answerQuery(const BusSnapshot& snap, const BusQuery& q, long long index, bool stats, QueryScratch& scratch, BusAnswer& ans);
+
+// 批量执行：threads 个线程并行回答，answers[i] 对应 queries[i]，JSON 中的查询序号从 firstIndex 起
+void runBusQueries(const BusSnapshot& snap, const std::vector<BusQuery>& queries, long long firstIndex, int threads, bool stats, std::vector<BusAnswer>& answers);
+
+// 在 Unix 域套接字 path 上提供查询服务（threads 个工作线程），直到监听套接字出错才返回
+// 协议：每行一条请求，格式与标准输入中的查询相同（“type 起点站 终点站”、“8 起点站”或线路变更），回答为相同的文本，以一个空行结束
+// 每条请求使用收到时的当前版本；线路变更由处理它的工作线程发布，其他线程上的查询不受阻塞
+// 单行请求上限 1 MB，超过时回复错误并关闭该连接；回答以阻塞方式写出，不读取回答的客户端会占住一个工作线程
+// 返回 0 表示正常结束，-1 表示无法监听（原因写到标准错误）
+int serveUnixSocket(BusVersions& versions, const char* path, int threads, bool stats);
+
+#endif
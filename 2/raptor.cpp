@@ -0,0 +1,191 @@
+#include "raptor.h"
+#include <ostream>
+#include <vector>
+#include <string>
+#include <limits>
+#include "../common/perf_stats.h"
+
+using namespace std;
+
+static const int INF_STOPS = numeric_limits<int>::max();
+
+RaptorJourney::RaptorJourney() : transfers(0), stops(0) {}
+
+RaptorWorkspace::RaptorWorkspace() : S(0), rows(0), epoch(0), tick(0) {}
+
+void RaptorWorkspace::begin(int stationCount, int rounds, int L) {
+    int needRows = rounds + 1;
+    if (stationCount != S || needRows > rows) {
+        S = stationCount;
+        rows = needRows > rows ? needRows : rows;
+        size_t cells = (size_t)rows * (size_t)S;
+        label.assign(cells, 0);
+        parentLine.assign(cells, 0);
+        boardPos.assign(cells, 0);
+        alightPos.assign(cells, 0);
+        rowStamp.assign(cells, 0);
+        best.assign(S, 0);
+        bestStamp.assign(S, 0);
+        epoch = 0;
+    }
+    if ((int)lineStamp.size() < L + 1) lineStamp.resize(L + 1, 0);
+    if (++epoch == 0) {
+        // epoch 回绕：旧时间戳可能与新值冲突，整体清零一次
+        rowStamp.assign(rowStamp.size(), 0);
+        bestStamp.assign(bestStamp.size(), 0);
+        epoch = 1;
+    }
+    marked.clear();
+    nextMarked.clear();
+    lines.clear();
+}
+
+// 本轮的下一个线路去重标记，回绕时清零
+static unsigned nextTick(RaptorWorkspace& ws) {
+    if (++ws.tick == 0) {
+        ws.lineStamp.assign(ws.lineStamp.size(), 0);
+        ws.tick = 1;
+    }
+    return ws.tick;
+}
+
+static int bestOf(const RaptorWorkspace& ws, int sid) {
+    return ws.bestStamp[sid] == ws.epoch ? ws.best[sid] : INF_STOPS;
+}
+
+// 第 r 轮以 stops 站到达位置 i 上的站点（上车位置 board）：严格优于已知最好值且优于终点才记录
+static void arrive(const BusNetwork& net, RaptorWorkspace& ws, int r, int line, int board, int i, int stops, int endSid) {
+    int sid = net.lineStop[i];
+    if (stops >= bestOf(ws, sid) || stops >= bestOf(ws, endSid)) return;
+    ws.best[sid] = stops;
+    ws.bestStamp[sid] = ws.epoch;
+    size_t cell = (size_t)r * ws.S + sid;
+    if (ws.rowStamp[cell] != ws.epoch) {
+        ws.rowStamp[cell] = ws.epoch;
+        ws.nextMarked.push_back(sid);
+    }
+    ws.label[cell] = stops;
+    ws.parentLine[cell] = line;
+    ws.boardPos[cell] = board;
+    ws.alightPos[cell] = i;
+    PERF_INC(PERF_STATES_PUSHED);
+}
+
+// 从第 r 轮终点记录回溯出方案：每一段从上车位置乘到下车位置，上车站在第 r-1 轮被改进
+static void buildJourney(const BusNetwork& net, const RaptorWorkspace& ws, int r, int startSid, int endSid, RaptorJourney& j) {
+    j.transfers = r - 1;
+    j.stops = ws.label[(size_t)r * ws.S + endSid];
+    j.lines.assign(r, 0);
+    vector< vector<int> > legs(r);
+    int sid = endSid;
+    for (int k = r; k >= 1; --k) {
+        size_t cell = (size_t)k * ws.S + sid;
+        int b = ws.boardPos[cell], a = ws.alightPos[cell];
+        j.lines[k - 1] = ws.parentLine[cell];
+        if (b <= a) {
+            for (int i = b; i <= a; ++i) legs[k - 1].push_back(net.lineStop[i]);
+        } else {
+            for (int i = b; i >= a; --i) legs[k - 1].push_back(net.lineStop[i]);
+        }
+        sid = net.lineStop[b];
+    }
+    j.stations.assign(1, startSid);
+    for (int k = 0; k < r; ++k) {
+        for (size_t i = 0; i < legs[k].size(); ++i) {
+            if (j.stations.back() != legs[k][i]) j.stations.push_back(legs[k][i]);
+        }
+    }
+}
+
+void raptorSearch(const BusNetwork& net, int startSid, int endSid, int maxTransfers, RaptorWorkspace& ws, vector<RaptorJourney>& journeys) {
+    journeys.clear();
+    // 轮数决定标签表行数：负数时不搜索，过大时按上限处理，不会分配空表或溢出
+    if (maxTransfers < 0) return;
+    if (maxTransfers > MAX_RAPTOR_TRANSFERS) maxTransfers = MAX_RAPTOR_TRANSFERS;
+    if (startSid == endSid) {
+        journeys.push_back(RaptorJourney());
+        journeys.back().stations.push_back(startSid);
+        return;
+    }
+    int rounds = maxTransfers + 1;
+    ws.begin(net.S, rounds, net.L);
+    ws.rowStamp[startSid] = ws.epoch;
+    ws.label[startSid] = 0;
+    ws.best[startSid] = 0;
+    ws.bestStamp[startSid] = ws.epoch;
+    ws.marked.push_back(startSid);
+
+    for (int r = 1; r <= rounds && !ws.marked.empty(); ++r) {
+        // 收集经过上一轮改进站点的线路（每条线路本轮只扫描一次）
+        unsigned t = nextTick(ws);
+        ws.lines.clear();
+        for (size_t i = 0; i < ws.marked.size(); ++i) {
+            int sid = ws.marked[i];
+            for (int k = net.stationStart[sid]; k < net.stationStart[sid + 1]; ++k) {
+                int l = net.stationLine[k];
+                if (ws.lineStamp[l] == t) continue;
+                ws.lineStamp[l] = t;
+                ws.lines.push_back(l);
+            }
+        }
+
+        // 双向扫描：cur 为当前所乘的最少站数，遇到上一轮改进的站点时若上车更优则换为从此处上车
+        size_t prevRow = (size_t)(r - 1) * ws.S;
+        for (size_t li = 0; li < ws.lines.size(); ++li) {
+            int l = ws.lines[li];
+            int first = net.lineStart[l], last = net.lineStart[l + 1] - 1;
+            PERF_INC(PERF_LINES_EXPANDED);
+            int cur = INF_STOPS, board = -1;
+            for (int i = first; i <= last; ++i) {
+                if (cur != INF_STOPS) arrive(net, ws, r, l, board, i, ++cur, endSid);
+                int sid = net.lineStop[i];
+                if (ws.rowStamp[prevRow + sid] == ws.epoch && ws.label[prevRow + sid] < cur) {
+                    cur = ws.label[prevRow + sid];
+                    board = i;
+                }
+            }
+            cur = INF_STOPS;
+            board = -1;
+            for (int i = last; i >= first; --i) {
+                if (cur != INF_STOPS) arrive(net, ws, r, l, board, i, ++cur, endSid);
+                int sid = net.lineStop[i];
+                if (ws.rowStamp[prevRow + sid] == ws.epoch && ws.label[prevRow + sid] < cur) {
+                    cur = ws.label[prevRow + sid];
+                    board = i;
+                }
+            }
+        }
+
+        // 本轮改进了终点：换乘 r-1 次的方案，站数必严格少于换乘更少的方案
+        if (ws.rowStamp[(size_t)r * ws.S + endSid] == ws.epoch) {
+            journeys.push_back(RaptorJourney());
+            buildJourney(net, ws, r, startSid, endSid, journeys.back());
+        }
+        ws.marked.swap(ws.nextMarked);
+        ws.nextMarked.clear();
+    }
+}
+
+void printRaptor(ostream& out, const vector<RaptorJourney>& journeys, int maxTransfers, const StationTable& names) {
+    if (journeys.empty()) {
+        out << "无可达路线（换乘不超过 " << maxTransfers << " 次）\n";
+        return;
+    }
+    out << "RAPTOR 方案数: " << journeys.size() << "\n";
+    for (size_t k = 0; k < journeys.size(); ++k) {
+        const RaptorJourney& j = journeys[k];
+        out << "方案 " << (k + 1) << ": 换乘次数 " << j.transfers << ", 总站数 " << j.stops << "\n";
+        out << "线路序列: ";
+        if (j.lines.empty()) out << "（无）";
+        for (size_t i = 0; i < j.lines.size(); ++i) {
+            if (i) out << " -> ";
+            out << "L" << j.lines[i];
+        }
+        out << "\n站点序列: ";
+        for (size_t i = 0; i < j.stations.size(); ++i) {
+            if (i) out << " -> ";
+            out << names.name(j.stations[i]);
+        }
+        out << "\n";
+    }
+}
@@ -0,0 +1,56 @@
+#ifndef RAPTOR_H
+#define RAPTOR_H
+
+// 轮次式（RAPTOR）公交路由：第 r 轮只允许乘坐 r 条线路（换乘 r-1 次）
+// 每轮从上一轮刚改进的站点上车，顺着线路站点数组双向扫描一遍，到达各站的“最少站数”只在严格变小时更新
+// 一次调用给出换乘 0..maxTransfers 次的全部 Pareto 方案：换乘多一次的方案必须站数更少才保留
+// 线路按站点序列双向通行；线路多次经过同一站时每次出现都可上下车
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include "bus.h"
+
+// 一个方案：lines 为依次乘坐的线路，stations 为经过的站点（首为起点、尾为终点）
+struct RaptorJourney {
+    int transfers;
+    int stops;
+    std::vector<int> lines;
+    std::vector<int> stations;
+    RaptorJourney();
+};
+
+// 查询工作区（调用方持有，跨查询复用）：每轮一行，按时间戳判定有效，查询之间不做 O(轮数×S) 复位
+// 第 r 行记录第 r 轮改进的站点：最少站数、所乘线路、上车与下车位置（lineStop 下标）；第 0 行只有起点
+struct RaptorWorkspace {
+    int S;
+    int rows;
+    std::vector<int> label;
+    std::vector<int> parentLine;
+    std::vector<int> boardPos;
+    std::vector<int> alightPos;
+    std::vector<unsigned> rowStamp;    // rowStamp[r*S+sid] == epoch：第 r 轮改进了 sid
+    std::vector<int> best;    // 到目前为止各站的最少站数（局部剪枝与目标剪枝）
+    std::vector<unsigned> bestStamp;
+    std::vector<unsigned> lineStamp;    // lineStamp[l] == tick：本轮已排入扫描
+    std::vector<int> marked;    // 上一轮改进的站点
+    std::vector<int> nextMarked;
+    std::vector<int> lines;    // 本轮待扫描的线路
+    unsigned epoch;
+    unsigned tick;    // 每轮递增，线路去重用
+    RaptorWorkspace();
+    // 开始一次新查询：按站点数与轮数扩容，epoch 回绕时整体清零
+    void begin(int S, int rounds, int L);
+};
+
+// maxTransfers 的上限：与换乘表的饱和计数一致
+static const int MAX_RAPTOR_TRANSFERS = 254;
+
+// 换乘不超过 maxTransfers 次的 Pareto 方案，按换乘次数升序（站数严格递减）；不可达时为空
+// 起点即终点时给出一个换乘 0 次、站数 0、不乘车的方案；maxTransfers 小于 0 时没有方案，超过上限时按上限处理
+void raptorSearch(const BusNetwork& net, int startSid, int endSid, int maxTransfers, RaptorWorkspace& ws, std::vector<RaptorJourney>& journeys);
+
+// 按 type=3 查询的格式输出全部方案
+void printRaptor(std::ostream& out, const std::vector<RaptorJourney>& journeys, int maxTransfers, const StationTable& names);
+
+#endif
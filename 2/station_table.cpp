@@ -0,0 +1,66 @@
+#include "station_table.h"
+
+using namespace std;
+
+// FNV-1a（64 位），高低 32 位折叠后作为槽位哈希
+static unsigned hashName(string_view s) {
+    unsigned long long h = 1469598103934665603ULL;
+    for (size_t i = 0; i < s.size(); ++i) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ULL;
+    }
+    return (unsigned)(h ^ (h >> 32));
+}
+
+StationTable::StationTable() : offset(1, 0) {}
+
+// 把编号 id（哈希 h）放入第一个空槽
+static void placeSlot(StationTable& t, int id, unsigned h) {
+    size_t mask = t.slots.size() - 1;
+    size_t i = h & mask;
+    while (t.slots[i] != -1) i = (i + 1) & mask;
+    t.slots[i] = id;
+    t.slotHash[i] = h;
+}
+
+// 槽数扩到不小于 2 × need 的 2 的幂，并重新放入已有站点（用保存的哈希值，不重算）
+static void growSlots(StationTable& t, size_t need) {
+    size_t cap = 16;
+    while (cap < 2 * need) cap <<= 1;
+    if (cap <= t.slots.size()) return;
+    vector<int> oldSlots;
+    vector<unsigned> oldHash;
+    oldSlots.swap(t.slots);
+    oldHash.swap(t.slotHash);
+    t.slots.assign(cap, -1);
+    t.slotHash.assign(cap, 0);
+    for (size_t i = 0; i < oldSlots.size(); ++i) {
+        if (oldSlots[i] != -1) placeSlot(t, oldSlots[i], oldHash[i]);
+    }
+}
+
+// 按哈希 h 探测名称 s，不存在返回 -1
+static int probe(const StationTable& t, string_view s, unsigned h) {
+    if (t.slots.empty()) return -1;
+    size_t mask = t.slots.size() - 1;
+    for (size_t i = h & mask; t.slots[i] != -1; i = (i + 1) & mask) {
+        if (t.slotHash[i] == h && t.name(t.slots[i]) == s) return t.slots[i];
+    }
+    return -1;
+}
+
+int StationTable::find(string_view s) const {
+    return probe(*this, s, hashName(s));
+}
+
+int StationTable::intern(string_view s) {
+    unsigned h = hashName(s);
+    int id = probe(*this, s, h);
+    if (id != -1) return id;
+    id = size();
+    if (2 * ((size_t)id + 1) > slots.size()) growSlots(*this, (size_t)id + 1);
+    arena.insert(arena.end(), s.begin(), s.end());
+    offset.push_back((unsigned)arena.size());
+    placeSlot(*this, id, h);
+    return id;
+}
@@ -0,0 +1,30 @@
+#ifndef STATION_TABLE_H
+#define STATION_TABLE_H
+
+// 站点名驻留表：编号 <-> 名称
+// 全部名称首尾相接存放在一块字符区 arena 中，编号 id 的名称为 arena[offset[id] .. offset[id+1])，不为每个名称单独分配
+// 名称 -> 编号用开放寻址哈希表（线性探测，装载率不超过 1/2），以 string_view 为键，查找期望 O(1)、不分配内存
+// 站点只增不减；查找只读，可由多个线程同时进行
+
+#include <vector>
+#include <string_view>
+
+struct StationTable {
+    std::vector<char> arena;
+    std::vector<unsigned> offset;    // 大小为站点数 + 1
+    std::vector<int> slots;    // 哈希槽中的站点编号，-1 为空槽；大小为 2 的幂
+    std::vector<unsigned> slotHash;    // 对应槽中名称的哈希值，探测时先比较哈希再比较名称
+    StationTable();
+
+    int size() const { return (int)offset.size() - 1; }
+    std::string_view name(int id) const {
+        return std::string_view(arena.data() + offset[id], offset[id + 1] - offset[id]);
+    }
+
+    // 名称查编号，不存在返回 -1
+    int find(std::string_view s) const;
+    // 名称查编号，不存在时追加为新站点
+    int intern(std::string_view s);
+};
+
+#endif
@@ -0,0 +1,100 @@
+#include "transfer_table.h"
+#include <vector>
+#include "../common/parallel.h"
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
+
+typedef unsigned long long Bits;
+
+TransferTable::TransferTable() : L(0) {}
+
+// 最低置位的下标（x 非 0）
+static int lowestBit(Bits x) {
+#ifdef _MSC_VER
+    unsigned long i;
+    _BitScanForward64(&i, x);
+    return (int)i;
+#else
+    return __builtin_ctzll(x);
+#endif
+}
+
+// 线程私有的位集：第 j 位对应本批第 j 条源线路
+struct BitBfsWorkspace {
+    vector<Bits> visited;
+    vector<Bits> frontier;
+    vector<Bits> next;
+};
+
+// 一批源线路 first..first+count-1 的位并行 BFS，结果写入各源线路所在的表行（只写 v <= 源线路的下三角部分，各批互不重叠）
+static void bitBfsBatch(const BusNetwork& net, int first, int count, BitBfsWorkspace& ws, TransferTable& table) {
+    int L = net.L;
+    ws.visited.assign(L + 1, 0);
+    ws.frontier.assign(L + 1, 0);
+    ws.next.assign(L + 1, 0);
+    Bits full = count == 64 ? ~(Bits)0 : (((Bits)1 << count) - 1);
+    for (int j = 0; j < count; ++j) {
+        int src = first + j;
+        ws.visited[src] |= (Bits)1 << j;
+        ws.frontier[src] |= (Bits)1 << j;
+        table.cells[(size_t)(src - 1) * src / 2 + (src - 1)] = 0;
+    }
+
+    bool active = true;
+    for (int d = 1; active; ++d) {
+        active = false;
+        unsigned char value = d < TRANSFER_SATURATED ? (unsigned char)d : TRANSFER_SATURATED;
+        for (int v = 1; v <= L; ++v) {
+            Bits acc = 0;
+            if (ws.visited[v] != full) {
+                for (int e = net.transferStart[v]; e < net.transferStart[v + 1]; ++e) acc |= ws.frontier[net.transferLine[e]];
+                acc &= ~ws.visited[v];
+            }
+            ws.next[v] = acc;
+        }
+        for (int v = 1; v <= L; ++v) {
+            Bits bits = ws.next[v];
+            if (!bits) continue;
+            active = true;
+            ws.visited[v] |= bits;
+            while (bits) {
+                int j = lowestBit(bits);
+                bits &= bits - 1;
+                int src = first + j;
+                if (v <= src) table.cells[(size_t)(src - 1) * src / 2 + (v - 1)] = value;
+            }
+        }
+        ws.frontier.swap(ws.next);
+    }
+}
+
+size_t buildTransferTable(const BusNetwork& net, int threads, TransferTable& table) {
+    int L = net.L;
+    table.L = L;
+    table.cells.assign((size_t)L * (L + 1) / 2, TRANSFER_UNREACHABLE);
+    int batches = (L + 63) / 64;
+    if (threads < 1) threads = 1;
+    if (threads > batches) threads = batches;
+    vector<BitBfsWorkspace> wsOf(threads > 0 ? threads : 1);
+    parallelFor(batches, threads, [&](int b, int tid) {
+        int first = 1 + b * 64;
+        int count = L - first + 1 < 64 ? L - first + 1 : 64;
+        bitBfsBatch(net, first, count, wsOf[tid], table);
+    });
+    return table.cells.size() + (size_t)wsOf.size() * 3 * (L + 1) * sizeof(Bits);
+}
+
+int stationTransfers(const BusNetwork& net, const TransferTable& table, int startSid, int endSid) {
+    int best = TRANSFER_UNREACHABLE;
+    for (int i = net.stationStart[startSid]; i < net.stationStart[startSid + 1]; ++i) {
+        int a = net.stationLine[i];
+        for (int k = net.stationStart[endSid]; k < net.stationStart[endSid + 1]; ++k) {
+            int d = lineTransfers(table, a, net.stationLine[k]);
+            if (d < best) best = d;
+        }
+    }
+    return best == TRANSFER_UNREACHABLE ? -1 : best;
+}
@@ -0,0 +1,37 @@
+#ifndef TRANSFER_TABLE_H
+#define TRANSFER_TABLE_H
+
+// 全部线路对的最少换乘表（离线构建一次，之后站点对查询只查表）
+// 构建：在线路换乘图上做位并行 BFS，一个 64 位字同时推进 64 条源线路的前沿（拉取式：v 的新前沿 = 邻线前沿按位或，去掉已访问位）
+// 各批源线路由 parallelFor 分给多个线程，每个线程持有自己的位集数组
+// 存储：换乘图无向，表对称，只存下三角：线路 a >= b 时 (a, b) 位于 cells[(a-1)*a/2 + (b-1)]，每格 1 字节
+
+#include <vector>
+#include <cstddef>
+#include "bus.h"
+
+static const unsigned char TRANSFER_UNREACHABLE = 255;
+static const unsigned char TRANSFER_SATURATED = 254;    // 换乘次数 >= 254 的线路对记为 254，查询时需回退到 BFS
+
+struct TransferTable {
+    int L;
+    std::vector<unsigned char> cells;
+    TransferTable();
+};
+
+// 构建全部线路对的最少换乘表；返回构建期间的峰值内存（表 + 各线程位集，字节）
+size_t buildTransferTable(const BusNetwork& net, int threads, TransferTable& table);
+
+// 线路 a、b 之间的最少换乘次数（查表），不可达返回 TRANSFER_UNREACHABLE
+inline int lineTransfers(const TransferTable& table, int a, int b) {
+    if (a < b) {
+        int t = a; a = b; b = t;
+    }
+    return table.cells[(size_t)(a - 1) * a / 2 + (b - 1)];
+}
+
+// 站点之间的最少换乘次数：起点站各线路 × 终点站各线路查表取最小，不可达返回 -1
+// 返回 TRANSFER_SATURATED 时真实值可能更大，调用方应改用 transferBfs
+int stationTransfers(const BusNetwork& net, const TransferTable& table, int startSid, int endSid);
+
+#endif
@@ -3,7 +3,10 @@
 #include <string>
 #include <limits>
 #include <ctime>
+#include <cstring>
 #include "parking.h"
+#include "../common/perf_stats.h"
+#include "../common/fast_input.h"
 #ifdef _WIN32
 #include <windows.h>
 #endif
@@ -11,9 +14,14 @@
 using namespace std;
 
 // 程序入口：读取输入，分别执行贪心与回溯调度，并输出结果
-int main() {
+int main(int argc, char** argv) {
+    // --stats：贪心与回溯各输出一行 JSON 统计到标准错误（计数需以 -DPERF_STATS 编译）
+    bool stats = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--stats") == 0) stats = true;
+    }
+
     ios::sync_with_stdio(false);
-    cin.tie(0);
 
 #ifdef _WIN32
     // 设置控制台使用 UTF-8，避免中文乱码
@@ -21,28 +29,39 @@ int main() {
     SetConsoleCP(65001);
 #endif
 
+    // 输入统一经 FastInput 读取：重定向自文件时整体映射，否则按块读入
+    FastInput in;
+    in.openStdin();
+
     int M, N;
-    if (!(cin >> M >> N)) {
+    if (!in.readInt(M) || !in.readInt(N)) {
         cout << "输入格式：\n";
         cout << "M N\n";
         cout << "K\n";
         cout << "K 行：到达时间 持续时间\n";
         cout << "快照时刻（snapshotTime）\n";
+        cout << "可选参数：--stats（向标准错误输出 JSON 统计，计数需 -DPERF_STATS 编译）\n";
         return 0;
     }
-    int K;
-    cin >> K;
+    int K = 0;
+    in.readInt(K);
     vector<Vehicle> cars;
     cars.reserve(K);
     for (int i = 1; i <= K; ++i) {
-        int a, d;
-        cin >> a >> d;
+        int a = 0, d = 0;
+        in.readInt(a);
+        in.readInt(d);
         cars.push_back(Vehicle(i, a, d));
     }
-    int snapshotTime;
-    cin >> snapshotTime;
+    int snapshotTime = 0;
+    in.readInt(snapshotTime);
+
+    if (stats && !perfStatsCompiled()) cerr << "统计计数未编译（需 -DPERF_STATS），仅输出耗时\n";
 
+    perfReset();
+    PerfTimer greedyTimer;
     ScheduleResult greedy = runGreedy(M, N, cars);
+    if (stats) perfWriteJson(cerr, "parking", 1, "greedy", greedyTimer.elapsedMs());
     cout << "[贪心算法]\n";
     cout << "总行驶距离：" << greedy.totalDistance << "\n";
     cout << "耗时(毫秒)：" << greedy.elapsedMs << "\n";
@@ -53,7 +72,10 @@ int main() {
 
     ScheduleResult best;
     if (K <= 12) {
+        perfReset();
+        PerfTimer backtrackTimer;
         best = runBacktracking(M, N, cars);
+        if (stats) perfWriteJson(cerr, "parking", 2, "backtracking", backtrackTimer.elapsedMs());
         cout << "[回溯搜索]\n";
         cout << "总行驶距离：" << best.totalDistance << "\n";
         cout << "耗时(毫秒)：" << best.elapsedMs << "\n";
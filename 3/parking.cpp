@@ -3,6 +3,7 @@
 #include <vector>
 #include <limits>
 #include <ctime>
+#include "../common/perf_stats.h"
 
 using namespace std;
 
@@ -170,9 +171,16 @@ static void dfsBacktrack(
     long long curDist
 ) {
     int K = (int)ctx.cars.size();
-    if (curDist >= ctx.bestDistance) return;
+    PERF_INC(PERF_DFS_NODES);
+    if (curDist >= ctx.bestDistance) {
+        PERF_INC(PERF_BOUND_PRUNES);
+        return;
+    }
     long long lb = curDist + lowerBoundRemain(ctx, K - idx);
-    if (lb >= ctx.bestDistance) return;
+    if (lb >= ctx.bestDistance) {
+        PERF_INC(PERF_BOUND_PRUNES);
+        return;
+    }
 
     if (idx == K) {
         ctx.bestDistance = curDist;
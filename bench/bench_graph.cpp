@@ -0,0 +1,270 @@
+// 题目1 最短路基准测试：比较不同优先队列（前沿）在两种代价模式下的表现
+// 生成带随机缺边的网格道路图，固定随机种子，对同一批随机查询分别计时
+// 另测节点编号被打乱的同一张图在 RCM 重编号前后的查询耗时
+// 一次双目标 Pareto 搜索与两次单目标 Dijkstra 的对比
+// 以及一对全部的 delta-stepping 在 1..maxThreads 个线程下的扩展性（以串行 Dijkstra 为基准）
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <cstdlib>
+#include <algorithm>
+#include <limits>
+#include "../1/graph.h"
+#include "../1/frontier.h"
+#include "../1/delta.h"
+#include "../common/parallel.h"
+#include "../1/reorder.h"
+#include "../1/pareto.h"
+#include "workloads.h"
+
+using namespace std;
+
+// 对一批查询运行某种前沿，返回总耗时（毫秒），并累计出堆与入堆次数
+template <class Cost, class Frontier>
+static double runFrontier(const CsrGraph& g, const Cost& cost, const vector< pair<int,int> >& queries, Frontier& pq, long long& settledSum, long long& pushSum) {
+    DijkstraWorkspace ws;
+    settledSum = 0;
+    pq.pushes = 0;
+    chrono::steady_clock::time_point st = chrono::steady_clock::now();
+    for (size_t i = 0; i < queries.size(); ++i) {
+        long long settled = 0;
+        dijkstra(g, cost, queries[i].first, queries[i].second, ws, pq, &settled);
+        settledSum += settled;
+    }
+    chrono::steady_clock::time_point ed = chrono::steady_clock::now();
+    pushSum = pq.pushes;
+    return chrono::duration<double, milli>(ed - st).count();
+}
+
+// 校验前驱是一棵以 s 为根的最短路树：每个可达节点的前驱边满足 dist[u] + w == dist[v]，且沿前驱回溯不成环
+static bool validTree(const CsrGraph& g, const vector<double>& w, int s, const vector<double>& dist, const vector<int>& prevNode) {
+    for (int v = 1; v <= g.n; ++v) {
+        if (v == s || dist[v] == numeric_limits<double>::infinity()) continue;
+        int u = prevNode[v];
+        if (u < 1 || u > g.n) return false;
+        bool tight = false;
+        for (int i = g.offset[u]; i < g.offset[u + 1] && !tight; ++i) tight = g.to[i] == v && dist[u] + w[i] == dist[v];
+        if (!tight) return false;
+    }
+    // state：0 未访问，1 在当前回溯链上，2 已确认能回到 s
+    vector<char> state(g.n + 1, 0);
+    state[s] = 2;
+    vector<int> chain;
+    for (int v = 1; v <= g.n; ++v) {
+        if (dist[v] == numeric_limits<double>::infinity()) continue;
+        int x = v;
+        while (state[x] == 0) {
+            state[x] = 1;
+            chain.push_back(x);
+            x = prevNode[x];
+        }
+        if (state[x] == 1) return false;
+        for (size_t k = 0; k < chain.size(); ++k) state[chain[k]] = 2;
+        chain.clear();
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    int side = argc > 1 ? atoi(argv[1]) : 300;    // 网格边长
+    int q = argc > 2 ? atoi(argv[2]) : 200;    // 查询数
+    unsigned seed = argc > 3 ? (unsigned)atoi(argv[3]) : 1;
+    int maxThreads = argc > 4 ? atoi(argv[4]) : defaultThreadCount();
+
+    vector<Road> roads;
+    makeGridRoads(side, side, seed, roads);
+    CsrGraph g;
+    buildCsrGraph(side * side, roads, g);
+
+    vector<double> lengthWeights, timeWeights;
+    precomputeWeights(g, LengthCost(), lengthWeights);
+    precomputeWeights(g, TravelTimeCost(), timeWeights);
+    const vector<double>* weightsOf[2] = { &lengthWeights, &timeWeights };
+
+    mt19937 rng(seed + 1);
+    uniform_int_distribution<int> nodeDist(1, g.n);
+    vector< pair<int,int> > queries;
+    for (int i = 0; i < q; ++i) queries.push_back(make_pair(nodeDist(rng), nodeDist(rng)));
+
+    cout << "nodes=" << g.n << " edges=" << g.m << " queries=" << q << "\n";
+    cout << left << setw(8) << "mode" << setw(10) << "frontier" << setw(14) << "total(ms)" << setw(14) << "settled" << "pushes\n";
+    cout << fixed << setprecision(2);
+    for (int mode = 0; mode < 2; ++mode) {
+        const char* modeName = mode == 0 ? "length" : "time";
+        PrecomputedCost cost(*weightsOf[mode]);
+        vector<double> radixWeights;
+        quantizeWeights(*weightsOf[mode], 1.0, radixWeights);    // 米 / 秒为单位取整
+        PrecomputedCost radixCost(radixWeights);
+        long long settled = 0, pushes = 0;
+
+        BinaryHeapFrontier bin;
+        double t0 = runFrontier(g, cost, queries, bin, settled, pushes);
+        cout << setw(8) << modeName << setw(10) << "binary" << setw(14) << t0 << setw(14) << settled << pushes << "\n";
+
+        QuaternaryHeapFrontier quad;
+        double t1 = runFrontier(g, cost, queries, quad, settled, pushes);
+        cout << setw(8) << modeName << setw(10) << "quad" << setw(14) << t1 << setw(14) << settled << pushes << "\n";
+
+        RadixHeapFrontier radix;
+        double t2 = runFrontier(g, radixCost, queries, radix, settled, pushes);
+        cout << setw(8) << modeName << setw(10) << "radix" << setw(14) << t2 << setw(14) << settled << pushes << "\n";
+    }
+
+    // 节点重编号：先随机打乱编号（模拟输入文件中编号与位置无关），再与 RCM 重编号后的图比较
+    vector<int> shuffled(g.n + 1, 0);
+    for (int v = 1; v <= g.n; ++v) shuffled[v] = v;
+    shuffle(shuffled.begin() + 1, shuffled.end(), mt19937(seed + 2));
+    vector<Road> shuffledRoads(roads);
+    for (size_t i = 0; i < shuffledRoads.size(); ++i) {
+        shuffledRoads[i].u = shuffled[shuffledRoads[i].u];
+        shuffledRoads[i].v = shuffled[shuffledRoads[i].v];
+    }
+    CsrGraph rg;
+    buildCsrGraph(g.n, shuffledRoads, rg);
+    NodeOrder order;
+    CsrGraph og;
+    chrono::steady_clock::time_point rst = chrono::steady_clock::now();
+    computeRcmOrder(rg, order);
+    permuteCsrGraph(rg, order, og);
+    double reorderMs = chrono::duration<double, milli>(chrono::steady_clock::now() - rst).count();
+    vector< pair<int,int> > shuffledQueries, orderedQueries;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        int s = shuffled[queries[i].first], t = shuffled[queries[i].second];
+        shuffledQueries.push_back(make_pair(s, t));
+        orderedQueries.push_back(make_pair(order.newOf[s], order.newOf[t]));
+    }
+    cout << "\nreorder (rcm) preprocessing(ms)=" << reorderMs << "\n";
+    cout << left << setw(8) << "mode" << setw(10) << "order" << setw(14) << "total(ms)" << "speedup\n";
+    for (int mode = 0; mode < 2; ++mode) {
+        const char* modeName = mode == 0 ? "length" : "time";
+        vector<double> rw, ow;
+        if (mode == 0) {
+            precomputeWeights(rg, LengthCost(), rw);
+            precomputeWeights(og, LengthCost(), ow);
+        } else {
+            precomputeWeights(rg, TravelTimeCost(), rw);
+            precomputeWeights(og, TravelTimeCost(), ow);
+        }
+        long long settled = 0, pushes = 0;
+        BinaryHeapFrontier bin;
+        double t0 = runFrontier(rg, PrecomputedCost(rw), shuffledQueries, bin, settled, pushes);
+        double t1 = runFrontier(og, PrecomputedCost(ow), orderedQueries, bin, settled, pushes);
+        cout << setw(8) << modeName << setw(10) << "shuffled" << setw(14) << t0 << 1.0 << "\n";
+        cout << setw(8) << modeName << setw(10) << "rcm" << setw(14) << t1 << t0 / t1 << "\n";
+    }
+
+    // Pareto：同一批查询，两次单目标 Dijkstra（长度 + 通行时间）对比一次双目标搜索
+    {
+        PrecomputedCost lengthCost(lengthWeights), timeCost(timeWeights);
+        DijkstraWorkspace ws;
+        long long settledSum = 0;
+        chrono::steady_clock::time_point pst = chrono::steady_clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            long long settled = 0;
+            dijkstra(g, lengthCost, queries[i].first, queries[i].second, ws, &settled);
+            settledSum += settled;
+            dijkstra(g, timeCost, queries[i].first, queries[i].second, ws, &settled);
+            settledSum += settled;
+        }
+        double twoRuns = chrono::duration<double, milli>(chrono::steady_clock::now() - pst).count();
+        cout << "\npareto\n";
+        cout << left << setw(18) << "method" << setw(14) << "total(ms)" << setw(14) << "settled" << "routes/query\n";
+        cout << setw(18) << "2x dijkstra" << setw(14) << twoRuns << setw(14) << settledSum << 2.0 << "\n";
+        int caps[3] = { 2, 4, 16 };
+        for (int c = 0; c < 3; ++c) {
+            ParetoWorkspace pws;
+            vector<ParetoRoute> routes;
+            long long labelSum = 0, routeSum = 0;
+            pst = chrono::steady_clock::now();
+            for (size_t i = 0; i < queries.size(); ++i) {
+                long long settled = 0;
+                paretoSearch(g, lengthWeights, timeWeights, queries[i].first, queries[i].second, caps[c], pws, routes, &settled);
+                labelSum += settled;
+                routeSum += (long long)routes.size();
+            }
+            double t = chrono::duration<double, milli>(chrono::steady_clock::now() - pst).count();
+            string name = "pareto(k=" + to_string(caps[c]) + ")";
+            cout << setw(18) << name << setw(14) << t << setw(14) << labelSum << (double)routeSum / (double)queries.size() << "\n";
+        }
+        AltLandmarks alt[2];
+        for (int mode = 0; mode < 2; ++mode) buildAltLandmarks(g, *weightsOf[mode], 8, alt[mode]);
+        vector<int> prevNode;
+        vector<double> dist;
+        settledSum = 0;
+        pst = chrono::steady_clock::now();
+        for (size_t i = 0; i < queries.size(); ++i) {
+            long long settled = 0;
+            for (int mode = 0; mode < 2; ++mode) {
+                altSearch(g, *weightsOf[mode], alt[mode], queries[i].first, queries[i].second, prevNode, dist, &settled);
+                settledSum += settled;
+            }
+        }
+        double twoAlt = chrono::duration<double, milli>(chrono::steady_clock::now() - pst).count();
+        cout << setw(18) << "2x alt" << setw(14) << twoAlt << setw(14) << settledSum << 2.0 << "\n";
+        for (int c = 0; c < 3; ++c) {
+            ParetoWorkspace pws;
+            vector<ParetoRoute> routes;
+            long long labelSum = 0, routeSum = 0;
+            pst = chrono::steady_clock::now();
+            for (size_t i = 0; i < queries.size(); ++i) {
+                long long settled = 0;
+                paretoSearch(g, lengthWeights, timeWeights, queries[i].first, queries[i].second, caps[c], pws, routes, &settled, alt);
+                labelSum += settled;
+                routeSum += (long long)routes.size();
+            }
+            double t = chrono::duration<double, milli>(chrono::steady_clock::now() - pst).count();
+            string name = "pareto+alt(k=" + to_string(caps[c]) + ")";
+            cout << setw(18) << name << setw(14) << t << setw(14) << labelSum << (double)routeSum / (double)queries.size() << "\n";
+        }
+    }
+
+    // delta-stepping 扩展性：同一组起点求一对全部，终点取不存在的 0 号节点使 Dijkstra 搜完全图
+    // 除两种代价外另测一组零权边（每 4 条道路取一条长度记为 0），核对距离与前驱树（零权边上前驱不能成环）
+    vector<double> zeroWeights(lengthWeights);
+    for (size_t r = 0; r < roads.size(); r += 4) {
+        if (g.roadSlot[2 * r] < 0) continue;
+        zeroWeights[g.roadSlot[2 * r]] = 0.0;
+        zeroWeights[g.roadSlot[2 * r + 1]] = 0.0;
+    }
+    const vector<double>* deltaWeightsOf[3] = { &lengthWeights, &timeWeights, &zeroWeights };
+    int sources = 5;
+    cout << "\none-to-all sources=" << sources << "\n";
+    cout << left << setw(8) << "mode" << setw(10) << "threads" << setw(14) << "total(ms)" << setw(10) << "speedup" << "check\n";
+    for (int mode = 0; mode < 3; ++mode) {
+        const char* modeName = mode == 0 ? "length" : (mode == 1 ? "time" : "zero-w");
+        const vector<double>& w = *deltaWeightsOf[mode];
+        PrecomputedCost cost(w);
+        DijkstraWorkspace ws;
+        vector< vector<double> > ref(sources);
+        chrono::steady_clock::time_point st = chrono::steady_clock::now();
+        for (int k = 0; k < sources; ++k) {
+            dijkstra(g, cost, queries[k].first, 0, ws);
+            ref[k].resize(g.n + 1);
+            for (int v = 1; v <= g.n; ++v) ref[k][v] = ws.distOf(v);
+        }
+        double base = chrono::duration<double, milli>(chrono::steady_clock::now() - st).count();
+        cout << setw(8) << modeName << setw(10) << "dijkstra" << setw(14) << base << setw(10) << 1.0 << "-\n";
+        for (int threads = 1; threads <= maxThreads; threads *= 2) {
+            vector<int> prevNode;
+            vector<double> dist;
+            bool same = true;
+            double t = 0.0;
+            // 线程池在各起点之间共用，计时不含线程创建
+            PhasePool pool(threads);
+            for (int k = 0; k < sources; ++k) {
+                st = chrono::steady_clock::now();
+                deltaStepping(g, w, queries[k].first, 0.0, pool, prevNode, dist);
+                t += chrono::duration<double, milli>(chrono::steady_clock::now() - st).count();
+                for (int v = 1; v <= g.n; ++v) same = same && dist[v] == ref[k][v];
+                same = same && validTree(g, w, queries[k].first, dist, prevNode);
+            }
+            cout << setw(8) << modeName << setw(10) << threads << setw(14) << t << setw(10) << base / t << (same ? "ok" : "MISMATCH") << "\n";
+            if (threads < maxThreads && threads * 2 > maxThreads) threads = maxThreads / 2;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,398 @@
+// 统一基准测试：三个题目的求解器在合成负载上的吞吐量与延迟分布
+// 每个用例先做 warmup 次不计时的运行，再计时 reps 次，每次运行一个样本（steady_clock）
+// 输出可读表格到标准输出；--json 文件 另写出机器可读结果，便于在版本之间比较
+// 以 -DPERF_STATS 编译时，JSON 中附带计时阶段累计的热点计数
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <sstream>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include "../1/graph.h"
+#include "../1/ch.h"
+#include "../2/bus.h"
+#include "../2/raptor.h"
+#include "../2/transfer_table.h"
+#include "../2/query_service.h"
+#include "../2/isochrone.h"
+#include "../common/parallel.h"
+#include "../3/parking.h"
+#include "../common/perf_stats.h"
+#include "workloads.h"
+
+using namespace std;
+
+// 一个用例的结果：样本为每次运行的耗时（毫秒）
+struct CaseResult {
+    string name;
+    string params;
+    vector<double> samples;
+    long long counters[PERF_COUNTER_COUNT];
+};
+
+// 最近秩百分位：samples 已升序
+static double percentile(const vector<double>& sorted, double p) {
+    if (sorted.empty()) return 0.0;
+    int idx = (int)ceil(p / 100.0 * (double)sorted.size()) - 1;
+    if (idx < 0) idx = 0;
+    if (idx >= (int)sorted.size()) idx = (int)sorted.size() - 1;
+    return sorted[idx];
+}
+
+// 运行一个用例：fn(i) 执行第 i 次运行（前 warmup 次不计时）
+template <class Fn>
+static CaseResult runCase(const string& name, const string& params, int warmup, int reps, Fn fn) {
+    CaseResult res;
+    res.name = name;
+    res.params = params;
+    for (int i = 0; i < warmup; ++i) fn(i);
+    perfReset();
+    for (int i = 0; i < reps; ++i) {
+        PerfTimer timer;
+        fn(warmup + i);
+        res.samples.push_back(timer.elapsedMs());
+    }
+    for (int c = 0; c < PERF_COUNTER_COUNT; ++c) res.counters[c] = perfCounters()[c];
+    return res;
+}
+
+static void printTable(const vector<CaseResult>& results) {
+    cout << left << setw(26) << "case" << right << setw(10) << "samples" << setw(14) << "ops/s" << setw(12) << "p50(ms)" << setw(12) << "p95(ms)" << setw(12) << "p99(ms)" << "  params\n";
+    cout << fixed << setprecision(3);
+    for (size_t k = 0; k < results.size(); ++k) {
+        vector<double> sorted(results[k].samples);
+        sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (size_t i = 0; i < sorted.size(); ++i) total += sorted[i];
+        double throughput = total > 0.0 ? 1000.0 * (double)sorted.size() / total : 0.0;
+        cout << left << setw(26) << results[k].name << right << setw(10) << sorted.size() << setw(14) << throughput
+             << setw(12) << percentile(sorted, 50) << setw(12) << percentile(sorted, 95) << setw(12) << percentile(sorted, 99)
+             << "  " << results[k].params << "\n";
+    }
+}
+
+static void writeJson(ostream& os, unsigned seed, int warmup, int reps, const vector<CaseResult>& results) {
+    os << fixed << setprecision(6);
+    os << "{\n  \"suite\": \"bench_suite\",\n  \"seed\": " << seed << ",\n  \"warmup\": " << warmup << ",\n  \"reps\": " << reps
+       << ",\n  \"perf_stats\": " << (perfStatsCompiled() ? "true" : "false") << ",\n  \"cases\": [\n";
+    for (size_t k = 0; k < results.size(); ++k) {
+        vector<double> sorted(results[k].samples);
+        sort(sorted.begin(), sorted.end());
+        double total = 0.0;
+        for (size_t i = 0; i < sorted.size(); ++i) total += sorted[i];
+        double throughput = total > 0.0 ? 1000.0 * (double)sorted.size() / total : 0.0;
+        os << "    {\"name\": \"" << results[k].name << "\", \"params\": \"" << results[k].params << "\""
+           << ", \"samples\": " << sorted.size() << ", \"total_ms\": " << total << ", \"throughput_per_s\": " << throughput
+           << ", \"mean_ms\": " << (sorted.empty() ? 0.0 : total / (double)sorted.size())
+           << ", \"p50_ms\": " << percentile(sorted, 50) << ", \"p95_ms\": " << percentile(sorted, 95)
+           << ", \"p99_ms\": " << percentile(sorted, 99) << ", \"max_ms\": " << (sorted.empty() ? 0.0 : sorted.back());
+        if (perfStatsCompiled()) {
+            os << ", \"counters\": {";
+            for (int c = 0; c < PERF_COUNTER_COUNT; ++c) os << (c ? ", " : "") << "\"" << perfCounterName(c) << "\": " << results[k].counters[c];
+            os << "}";
+        }
+        os << "}" << (k + 1 < results.size() ? "," : "") << "\n";
+    }
+    os << "  ]\n}\n";
+}
+
+// 道路图用例：同一张图上两种代价模式各一组随机点对查询
+static void benchRoads(const string& kind, const string& params, const vector<Road>& roads, int n, unsigned seed, int warmup, int reps, vector<CaseResult>& results) {
+    CsrGraph g;
+    buildCsrGraph(n, roads, g);
+    vector<double> lengthWeights, timeWeights;
+    precomputeWeights(g, LengthCost(), lengthWeights);
+    precomputeWeights(g, TravelTimeCost(), timeWeights);
+    mt19937 rng(seed + 1);
+    uniform_int_distribution<int> nodeDist(1, n);
+    vector< pair<int,int> > queries;
+    for (int i = 0; i < warmup + reps; ++i) queries.push_back(make_pair(nodeDist(rng), nodeDist(rng)));
+
+    ostringstream full;
+    full << params << " nodes=" << g.n << " edges=" << g.m;
+    DijkstraWorkspace ws;
+    PrecomputedCost lengthCost(lengthWeights), timeCost(timeWeights);
+    results.push_back(runCase("road/" + kind + "/length", full.str(), warmup, reps, [&](int i) {
+        dijkstra(g, lengthCost, queries[i].first, queries[i].second, ws);
+    }));
+    results.push_back(runCase("road/" + kind + "/time", full.str(), warmup, reps, [&](int i) {
+        dijkstra(g, timeCost, queries[i].first, queries[i].second, ws);
+    }));
+
+    // 多对多距离矩阵（加权通行时间）：每次运行取 32 个起点 × 32 个终点，各行并行计算；
+    // 单线程与硬件并发数各测一次，比较吞吐量即为按行并行的扩展性；计时前把一个矩阵按 DISTMAT1 写出再读回，核对逐项相同
+    const int side = 32;
+    vector<int> sources(side), targets(side);
+    auto pickMatrix = [&](int i) {
+        mt19937 r(seed + 11 + (unsigned)i);
+        for (int k = 0; k < side; ++k) {
+            sources[k] = 1 + (int)(r() % (unsigned)n);
+            targets[k] = 1 + (int)(r() % (unsigned)n);
+        }
+    };
+    vector<double> matrix, readBack;
+    pickMatrix(0);
+    distanceMatrix(g, timeWeights, sources, targets, matrix, 1);
+    stringstream buffer;
+    int rows = 0, cols = 0;
+    bool roundTrip = writeDistanceMatrix(buffer, side, side, matrix) && readDistanceMatrix(buffer, rows, cols, readBack)
+        && rows == side && cols == side && memcmp(&readBack[0], &matrix[0], matrix.size() * sizeof(double)) == 0;
+    int threadCounts[2] = { 1, defaultThreadCount() };
+    for (int k = 0; k < (threadCounts[1] > 1 ? 2 : 1); ++k) {
+        int threads = threadCounts[k];
+        ostringstream matrixParams;
+        matrixParams << full.str() << " size=" << side << "x" << side << " threads=" << threads << " roundtrip=" << (roundTrip ? "ok" : "FAILED");
+        results.push_back(runCase("road/" + kind + "/matrix" + (k == 0 ? "" : "_parallel"), matrixParams.str(), warmup, reps, [&](int i) {
+            pickMatrix(i);
+            distanceMatrix(g, timeWeights, sources, targets, matrix, threads);
+        }));
+    }
+
+    // 收缩层次：每种模式预处理一次（单独计时，耗时与捷径数记在参数中），之后每次查询只做双向向上搜索并展开路径
+    const vector<double>* weightsOf[2] = { &lengthWeights, &timeWeights };
+    const char* modeName[2] = { "length", "time" };
+    for (int mode = 0; mode < 2; ++mode) {
+        ContractionHierarchy ch;
+        PerfTimer buildTimer;
+        buildContractionHierarchy(g, *weightsOf[mode], ch);
+        ostringstream chParams;
+        chParams << full.str() << " build_ms=" << buildTimer.elapsedMs() << " up_arcs=" << ch.upTo.size();
+        ChQueryWorkspace chWs;
+        vector<int> path;
+        double dist = 0.0;
+        results.push_back(runCase("road/" + kind + "/ch_" + modeName[mode], chParams.str(), warmup, reps, [&](int i) {
+            chQuery(ch, chWs, queries[i].first, queries[i].second, path, dist);
+        }));
+    }
+}
+
+// 公交用例：按 2/main.cpp 的方式建立线路/站点索引，起终点取随机的有线路站点
+static void benchBus(int L, int S, int stops, unsigned seed, int warmup, int reps, vector<CaseResult>& results) {
+    vector< vector<int> > lineStations;
+    vector<string> nameOf;
+    makeBusNetwork(L, S, stops, seed, lineStations, nameOf);
+    BusNetwork net;
+    buildBusNetwork(S, lineStations, net);
+    TransferWorkspace transferWs;
+    WeightedWorkspace weightedWs;
+    RaptorWorkspace raptorWs;
+    BusRoute route;
+    vector<RaptorJourney> journeys;
+    vector<int> served;
+    for (int sid = 0; sid < S; ++sid) {
+        if (net.stationStart[sid] != net.stationStart[sid + 1]) served.push_back(sid);
+    }
+    mt19937 rng(seed + 1);
+    uniform_int_distribution<int> pick(0, (int)served.size() - 1);
+    vector< pair<int,int> > queries;
+    for (int i = 0; i < warmup + reps; ++i) queries.push_back(make_pair(served[pick(rng)], served[pick(rng)]));
+
+    ostringstream params;
+    params << "lines=" << L << " stations=" << S << " stops=" << stops;
+    results.push_back(runCase("bus/min_transfers", params.str(), warmup, reps, [&](int i) {
+        solveMinTransfers(net, queries[i].first, queries[i].second, transferWs, route);
+    }));
+    results.push_back(runCase("bus/weighted", params.str(), warmup, reps, [&](int i) {
+        solveWeighted(net, queries[i].first, queries[i].second, weightedWs, route);
+    }));
+    // RAPTOR 一次给出换乘 0..8 次的全部 Pareto 方案，其中换乘最少的一个即综合最优的答案
+    results.push_back(runCase("bus/raptor", params.str(), warmup, reps, [&](int i) {
+        raptorSearch(net, queries[i].first, queries[i].second, 8, raptorWs, journeys);
+    }));
+
+    // 全部线路对的换乘表：构建一次（单独计时），之后每次查询只查表
+    TransferTable table;
+    PerfTimer buildTimer;
+    size_t bytes = buildTransferTable(net, defaultThreadCount(), table);
+    ostringstream tableParams;
+    tableParams << params.str() << " build_ms=" << buildTimer.elapsedMs() << " table_bytes=" << table.cells.size() << " peak_bytes=" << bytes;
+    results.push_back(runCase("bus/transfer_table", tableParams.str(), warmup, reps, [&](int i) {
+        stationTransfers(net, table, queries[i].first, queries[i].second);
+    }));
+
+    // 查询服务的批量执行：每次运行为一批综合最优查询（含输出格式化），由全部硬件线程并行回答
+    BusSnapshot snap;
+    snap.net = net;
+    shared_ptr<StationTable> names = make_shared<StationTable>();
+    for (int sid = 0; sid < S; ++sid) names->intern(nameOf[sid]);
+    snap.names = names;
+    int batchSize = 64, threads = defaultThreadCount();
+    vector<BusQuery> batch(batchSize);
+    vector<BusAnswer> answers;
+    ostringstream batchParams;
+    batchParams << params.str() << " batch=" << batchSize << " threads=" << threads;
+    results.push_back(runCase("bus/batch_weighted", batchParams.str(), warmup, reps, [&](int i) {
+        for (int k = 0; k < batchSize; ++k) {
+            const pair<int,int>& qk = queries[(i * batchSize + k) % queries.size()];
+            batch[k].type = 2;
+            batch[k].startSid = qk.first;
+            batch[k].endSid = qk.second;
+        }
+        runBusQueries(snap, batch, 0, threads, false, answers);
+    }));
+
+    // 一对多：每次运行从一个起点求到全部站点的结果；多起点版本每次运行一批起点，由全部硬件线程并行求解
+    Isochrone iso;
+    results.push_back(runCase("bus/isochrone", params.str(), warmup, reps, [&](int i) {
+        solveIsochrone(net, queries[i].first, weightedWs, iso);
+    }));
+    int originCount = 16;
+    vector<int> origins(originCount);
+    vector<Isochrone> isos;
+    ostringstream isoParams;
+    isoParams << params.str() << " origins=" << originCount << " threads=" << threads;
+    results.push_back(runCase("bus/isochrone_batch", isoParams.str(), warmup, reps, [&](int i) {
+        for (int k = 0; k < originCount; ++k) origins[k] = queries[(i * originCount + k) % queries.size()].first;
+        solveIsochrones(net, origins, threads, isos);
+    }));
+
+    // 站点名解析：每次运行按名称查 1000 个随机站点，对比驻留表（开放寻址哈希）与 map<string, int>
+    vector<string> lookups;
+    for (int i = 0; i < 1000; ++i) lookups.push_back(nameOf[served[pick(rng)]]);
+    map<string, int, less<> > nameMap;
+    for (int sid = 0; sid < S; ++sid) nameMap.insert(make_pair(nameOf[sid], sid));
+    volatile long long sink = 0;    // 防止查找结果被优化掉
+    results.push_back(runCase("bus/name_lookup", params.str() + " names=1000", warmup, reps, [&](int) {
+        for (size_t k = 0; k < lookups.size(); ++k) sink = sink + names->find(lookups[k]);
+    }));
+    results.push_back(runCase("bus/name_lookup_map", params.str() + " names=1000", warmup, reps, [&](int) {
+        for (size_t k = 0; k < lookups.size(); ++k) sink = sink + nameMap.find(string_view(lookups[k]))->second;
+    }));
+    results.push_back(runCase("bus/name_intern", params.str(), warmup, reps, [&](int) {
+        StationTable t;
+        for (int sid = 0; sid < S; ++sid) sink = sink + t.intern(nameOf[sid]);
+    }));
+
+    // 线路变更：把一条随机线路替换为另一条线路的站点序列，增量构建新版本，对比从全部线路重新构建
+    vector<LineDelta> deltas(1);
+    vector< vector<int> > changedLines = lineStations;
+    BusNetwork next;
+    auto pickDelta = [&](int i) {
+        mt19937 r(seed + 7 + (unsigned)i);
+        deltas[0].line = 1 + (int)(r() % L);
+        deltas[0].stations = lineStations[1 + r() % L];
+    };
+    results.push_back(runCase("bus/line_delta", params.str(), warmup, reps, [&](int i) {
+        pickDelta(i);
+        applyLineDeltas(net, S, deltas, next);
+    }));
+    results.push_back(runCase("bus/full_rebuild", params.str(), warmup, reps, [&](int i) {
+        pickDelta(i);
+        changedLines[deltas[0].line].swap(deltas[0].stations);
+        buildBusNetwork(S, changedLines, next);
+        changedLines[deltas[0].line] = lineStations[deltas[0].line];
+    }));
+
+    // 经查询服务发布：line_update 为持写锁的部分（增量构建，新版本不带换乘表），
+    // line_update_table 另含写锁之外补建换乘表，即变更后 type=4 重新查表前的全部代价；每次运行前恢复为带表的原版本
+    BusVersions versions;
+    shared_ptr<BusSnapshot> base = make_shared<BusSnapshot>(snap);
+    base->table = table;
+    base->tableReady = true;
+    vector<string_view> views;
+    auto pickUpdate = [&](int i) {
+        pickDelta(i);
+        views.clear();
+        for (size_t k = 0; k < deltas[0].stations.size(); ++k) views.push_back(nameOf[deltas[0].stations[k]]);
+        publishSnapshot(versions, base);
+    };
+    ostringstream updateParams;
+    updateParams << params.str() << " threads=" << threads;
+    results.push_back(runCase("bus/line_update", updateParams.str(), warmup, reps, [&](int i) {
+        pickUpdate(i);
+        applyLineUpdate(versions, deltas[0].line, views);
+    }));
+    results.push_back(runCase("bus/line_update_table", updateParams.str(), warmup, reps, [&](int i) {
+        pickUpdate(i);
+        applyLineUpdate(versions, deltas[0].line, views);
+        refreshTransferTable(versions, threads);
+    }));
+}
+
+// 停车场用例：每次运行使用不同种子生成的到达序列
+static void benchParking(int M, int N, int K, int btK, unsigned seed, int warmup, int reps, vector<CaseResult>& results) {
+    int maxDuration = 4 * M * N;
+    ostringstream params;
+    params << "M=" << M << " N=" << N << " K=" << K;
+    results.push_back(runCase("parking/greedy", params.str(), warmup, reps, [&](int i) {
+        vector<Vehicle> cars;
+        makeParkingStream(K, 3, maxDuration, seed + (unsigned)i, cars);
+        runGreedy(M, N, cars);
+    }));
+    ostringstream btParams;
+    btParams << "M=" << M << " N=" << N << " K=" << btK;
+    results.push_back(runCase("parking/backtracking", btParams.str(), warmup, reps, [&](int i) {
+        vector<Vehicle> cars;
+        makeParkingStream(btK, 3, maxDuration, seed + (unsigned)i, cars);
+        runBacktracking(M, N, cars);
+    }));
+}
+
+int main(int argc, char** argv) {
+    unsigned seed = 1;
+    int warmup = 5, reps = 50;
+    int roadSide = 200, geoNodes = 40000;
+    double geoDegree = 6.0;
+    int busLines = 200, busStations = 5000, busStops = 30;
+    int parkM = 10, parkN = 10, parkK = 200, btK = 6;
+    const char* jsonFile = 0;
+    string only;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) seed = (unsigned)atoi(argv[++i]);
+        else if (strcmp(argv[i], "--warmup") == 0 && i + 1 < argc) warmup = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--reps") == 0 && i + 1 < argc) reps = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--road-side") == 0 && i + 1 < argc) roadSide = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--geo-nodes") == 0 && i + 1 < argc) geoNodes = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--geo-degree") == 0 && i + 1 < argc) geoDegree = atof(argv[++i]);
+        else if (strcmp(argv[i], "--bus") == 0 && i + 3 < argc) {
+            busLines = atoi(argv[++i]);
+            busStations = atoi(argv[++i]);
+            busStops = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--parking") == 0 && i + 3 < argc) {
+            parkM = atoi(argv[++i]);
+            parkN = atoi(argv[++i]);
+            parkK = atoi(argv[++i]);
+        } else if (strcmp(argv[i], "--bt-k") == 0 && i + 1 < argc) btK = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--only") == 0 && i + 1 < argc) only = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc) jsonFile = argv[++i];
+        else {
+            cout << "用法: bench_suite [--seed s] [--warmup w] [--reps r] [--only road|bus|parking]\n";
+            cout << "                  [--road-side n] [--geo-nodes n] [--geo-degree d]\n";
+            cout << "                  [--bus 线路数 站点数 每线站数] [--parking M N K] [--bt-k K] [--json 文件]\n";
+            return 0;
+        }
+    }
+
+    vector<CaseResult> results;
+    if (only.empty() || only == "road") {
+        vector<Road> roads;
+        makeGridRoads(roadSide, roadSide, seed, roads);
+        ostringstream grid;
+        grid << "side=" << roadSide;
+        benchRoads("grid", grid.str(), roads, roadSide * roadSide, seed, warmup, reps, results);
+        makeGeometricRoads(geoNodes, geoDegree, seed, roads);
+        ostringstream geo;
+        geo << "degree=" << geoDegree;
+        benchRoads("geometric", geo.str(), roads, geoNodes, seed, warmup, reps, results);
+    }
+    if (only.empty() || only == "bus") benchBus(busLines, busStations, busStops, seed, warmup, reps, results);
+    if (only.empty() || only == "parking") benchParking(parkM, parkN, parkK, btK, seed, warmup, reps, results);
+
+    printTable(results);
+    if (jsonFile) {
+        ofstream out(jsonFile);
+        if (!out) {
+            cout << "无法写出: " << jsonFile << "\n";
+            return 1;
+        }
+        writeJson(out, seed, warmup, reps, results);
+    }
+    return 0;
+}
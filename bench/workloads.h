@@ -0,0 +1,124 @@
+#ifndef WORKLOADS_H
+#define WORKLOADS_H
+
+// 基准测试用的合成负载生成器（固定随机种子，结果可复现）
+// - 道路图：带随机缺边的网格图、随机几何图（单位正方形内撒点，距离阈值内连边）
+// - 公交网络：S 个站点排成近似方阵，每条线路是一条不重复经过站点的随机游走
+// - 停车场：到达时刻单调不减的车辆序列
+
+#include <vector>
+#include <string>
+#include <random>
+#include <cmath>
+#include <algorithm>
+#include "../1/graph.h"
+#include "../3/parking.h"
+
+// 网格道路图：rows*cols 个节点，相邻节点以 90% 概率连边
+inline void makeGridRoads(int rows, int cols, unsigned seed, std::vector<Road>& roads) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<double> lenDist(50.0, 500.0);
+    std::uniform_real_distribution<double> congDist(1.0, 3.0);
+    std::uniform_int_distribution<int> lightDist(0, 3);
+    std::uniform_real_distribution<double> keep(0.0, 1.0);
+    roads.clear();
+    for (int r = 0; r < rows; ++r) {
+        for (int c = 0; c < cols; ++c) {
+            int u = r * cols + c + 1;
+            if (c + 1 < cols && keep(rng) < 0.9) roads.push_back(Road(u, u + 1, lenDist(rng), congDist(rng), lightDist(rng)));
+            if (r + 1 < rows && keep(rng) < 0.9) roads.push_back(Road(u, u + cols, lenDist(rng), congDist(rng), lightDist(rng)));
+        }
+    }
+}
+
+// 随机几何图：n 个点均匀分布在边长 sqrt(n) 公里的正方形内，距离不超过 radius 的点对连边（期望度数约 avgDegree）
+// 道路长度为欧氏距离（米），节点编号按撒点顺序，与位置无关
+inline void makeGeometricRoads(int n, double avgDegree, unsigned seed, std::vector<Road>& roads) {
+    std::mt19937 rng(seed);
+    double side = std::sqrt((double)n) * 1000.0;
+    std::uniform_real_distribution<double> coord(0.0, side);
+    std::uniform_real_distribution<double> congDist(1.0, 3.0);
+    std::uniform_int_distribution<int> lightDist(0, 3);
+    std::vector<double> x(n + 1), y(n + 1);
+    for (int v = 1; v <= n; ++v) {
+        x[v] = coord(rng);
+        y[v] = coord(rng);
+    }
+    // 单位面积点密度为 n/side^2，半径 radius 的圆内期望点数为 avgDegree
+    double radius = std::sqrt(avgDegree * side * side / (3.141592653589793 * (double)n));
+    int cells = std::max(1, (int)(side / radius));
+    double cellSize = side / (double)cells;
+    std::vector< std::vector<int> > bucket((size_t)cells * cells);
+    for (int v = 1; v <= n; ++v) {
+        int cx = std::min(cells - 1, (int)(x[v] / cellSize));
+        int cy = std::min(cells - 1, (int)(y[v] / cellSize));
+        bucket[(size_t)cy * cells + cx].push_back(v);
+    }
+    roads.clear();
+    for (int v = 1; v <= n; ++v) {
+        int cx = std::min(cells - 1, (int)(x[v] / cellSize));
+        int cy = std::min(cells - 1, (int)(y[v] / cellSize));
+        for (int dy = -1; dy <= 1; ++dy) {
+            for (int dx = -1; dx <= 1; ++dx) {
+                int bx = cx + dx, by = cy + dy;
+                if (bx < 0 || by < 0 || bx >= cells || by >= cells) continue;
+                const std::vector<int>& b = bucket[(size_t)by * cells + bx];
+                for (size_t k = 0; k < b.size(); ++k) {
+                    int u = b[k];
+                    if (u <= v) continue;
+                    double d = std::sqrt((x[u] - x[v]) * (x[u] - x[v]) + (y[u] - y[v]) * (y[u] - y[v]));
+                    if (d > radius) continue;
+                    roads.push_back(Road(v, u, d, congDist(rng), lightDist(rng)));
+                }
+            }
+        }
+    }
+}
+
+// 公交网络：站点 0..S-1 排成 side*side 方阵，每条线路从随机站点出发，在四邻域内随机游走 stopsPerLine 站（不重复经过）
+// lineStations[1..L] 为各线路站点序列，nameOf[sid] 为站点名称 "S<sid>"
+inline void makeBusNetwork(int L, int S, int stopsPerLine, unsigned seed, std::vector< std::vector<int> >& lineStations, std::vector<std::string>& nameOf) {
+    std::mt19937 rng(seed);
+    int side = std::max(1, (int)std::ceil(std::sqrt((double)S)));
+    std::uniform_int_distribution<int> stationDist(0, S - 1);
+    lineStations.assign(L + 1, std::vector<int>());
+    std::vector<int> visitedBy(S, 0);
+    for (int l = 1; l <= L; ++l) {
+        int cur = stationDist(rng);
+        lineStations[l].push_back(cur);
+        visitedBy[cur] = l;
+        while ((int)lineStations[l].size() < stopsPerLine) {
+            int r = cur / side, c = cur % side;
+            int next[4], cnt = 0;
+            int dr[4] = { -1, 1, 0, 0 }, dc[4] = { 0, 0, -1, 1 };
+            for (int k = 0; k < 4; ++k) {
+                int nr = r + dr[k], nc = c + dc[k];
+                if (nr < 0 || nc < 0 || nc >= side) continue;
+                int sid = nr * side + nc;
+                if (sid >= S || visitedBy[sid] == l) continue;
+                next[cnt++] = sid;
+            }
+            if (cnt == 0) break;
+            cur = next[std::uniform_int_distribution<int>(0, cnt - 1)(rng)];
+            lineStations[l].push_back(cur);
+            visitedBy[cur] = l;
+        }
+    }
+    nameOf.resize(S);
+    for (int sid = 0; sid < S; ++sid) nameOf[sid] = "S" + std::to_string(sid);
+}
+
+// 停车场到达序列：K 辆车，相邻到达间隔 0..maxGap，停放时长 1..maxDuration
+inline void makeParkingStream(int K, int maxGap, int maxDuration, unsigned seed, std::vector<Vehicle>& cars) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> gapDist(0, maxGap);
+    std::uniform_int_distribution<int> durDist(1, maxDuration);
+    cars.clear();
+    int t = 0;
+    for (int i = 1; i <= K; ++i) {
+        t += gapDist(rng);
+        cars.push_back(Vehicle(i, t, durDist(rng)));
+    }
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef FAST_INPUT_H
+#define FAST_INPUT_H
+
+// 快速输入（三个题目共用，仅头文件）：代替 cin 逐词读取
+// 标准输入重定向自普通文件时整体映射（零拷贝）；管道、终端则按块读入，终端下仍可逐行交互
+// 词法与 cin >> 一致：以空白分隔；整数、浮点数用 from_chars 原地解析，词元以 string_view 返回，不逐词分配
+
+#include <vector>
+#include <string_view>
+#include <charconv>
+#include <cstring>
+#include <system_error>
+#include "mapped_file.h"
+#ifdef _WIN32
+#include <io.h>
+#endif
+
+class FastInput {
+public:
+    FastInput() : data(0), pos(0), end(0), eof(false) {}
+
+    // 绑定标准输入；未调用 openStdin 时首次读取自动以块读方式读标准输入
+    void openStdin() {
+        if (map.openStdin()) {
+            data = map.data;
+            pos = 0;
+            end = map.size;
+            eof = true;
+        }
+    }
+
+    // 读一个词元；返回的视图在下一次读取前有效，读到结尾时为空
+    bool readToken(std::string_view& tok) {
+        tok = std::string_view();
+        for (;;) {
+            while (pos < end && isSpace(data[pos])) ++pos;
+            if (pos < end) break;
+            if (!refill()) return false;
+        }
+        size_t len = 0;
+        for (;;) {
+            while (pos + len < end && !isSpace(data[pos + len])) ++len;
+            if (pos + len < end || !refill()) break;
+        }
+        tok = std::string_view(data + pos, len);
+        pos += len;
+        return true;
+    }
+
+    bool readInt(int& x) {
+        std::string_view tok;
+        if (!readToken(tok)) return false;
+        return parseNumber(tok, x);
+    }
+
+    bool readDouble(double& x) {
+        std::string_view tok;
+        if (!readToken(tok)) return false;
+        return parseNumber(tok, x);
+    }
+
+private:
+    MappedFile map;
+    std::vector<char> buf;
+    const char* data;
+    size_t pos, end;
+    bool eof;
+
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f';
+    }
+
+    // 整个词元须是合法数字（允许前导 '+'，与 cin 一致）；失败时 x 不变
+    template <class T>
+    static bool parseNumber(std::string_view tok, T& x) {
+        const char* b = tok.data();
+        const char* e = b + tok.size();
+        if (b < e && *b == '+') ++b;
+        T v;
+        std::from_chars_result r = std::from_chars(b, e, v);
+        if (r.ec != std::errc() || r.ptr != e) return false;
+        x = v;
+        return true;
+    }
+
+    // 块读：未消费的部分移到缓冲区开头，缓冲区满时扩容，再读入一块；映射模式或已到结尾返回 false
+    bool refill() {
+        if (eof) return false;
+        size_t keep = end - pos;
+        if (keep && pos) memmove(&buf[0], &buf[pos], keep);
+        pos = 0;
+        end = keep;
+        if (buf.empty()) buf.resize(1 << 20);
+        else if (end == buf.size()) buf.resize(buf.size() * 2);
+#ifdef _WIN32
+        long n = _read(0, &buf[end], (unsigned)(buf.size() - end));
+#else
+        long n = (long)::read(0, &buf[end], buf.size() - end);
+#endif
+        data = &buf[0];
+        if (n <= 0) {
+            eof = true;
+            return false;
+        }
+        end += (size_t)n;
+        return true;
+    }
+};
+
+#endif
@@ -0,0 +1,149 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+// 只读文件映射（三个题目共用，仅头文件）：POSIX 用 mmap，Windows 用 MapViewOfFile
+// 用于图快照的零拷贝加载，以及标准输入重定向自普通文件时的整体映射
+
+#include <cstddef>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+// 不可复制，析构时解除映射；只关闭自己打开的文件（标准输入不关闭）
+struct MappedFile {
+    const char* data;
+    size_t size;
+#ifdef _WIN32
+    void* fileHandle;
+    void* mapHandle;
+#else
+    int fd;
+#endif
+    bool ownsFile;
+    MappedFile();
+    ~MappedFile();
+    bool open(const char* file);
+    // 标准输入是非空普通文件（如 < input.txt）时映射之；管道、终端返回 false
+    bool openStdin();
+    void close();
+private:
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+#ifdef _WIN32
+    bool mapHandleOf(HANDLE f, bool owns);
+#else
+    bool mapDescriptor(int f, bool owns);
+#endif
+};
+
+inline MappedFile::MappedFile() : data(0), size(0), ownsFile(false) {
+#ifdef _WIN32
+    fileHandle = 0;
+    mapHandle = 0;
+#else
+    fd = -1;
+#endif
+}
+
+inline MappedFile::~MappedFile() {
+    close();
+}
+
+#ifdef _WIN32
+inline bool MappedFile::mapHandleOf(HANDLE f, bool owns) {
+    LARGE_INTEGER sz;
+    if (GetFileType(f) != FILE_TYPE_DISK || !GetFileSizeEx(f, &sz) || sz.QuadPart == 0) {
+        if (owns) CloseHandle(f);
+        return false;
+    }
+    HANDLE m = CreateFileMappingA(f, 0, PAGE_READONLY, 0, 0, 0);
+    if (!m) {
+        if (owns) CloseHandle(f);
+        return false;
+    }
+    void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+    if (!p) {
+        CloseHandle(m);
+        if (owns) CloseHandle(f);
+        return false;
+    }
+    fileHandle = f;
+    mapHandle = m;
+    ownsFile = owns;
+    data = (const char*)p;
+    size = (size_t)sz.QuadPart;
+    return true;
+}
+
+inline bool MappedFile::open(const char* file) {
+    close();
+    HANDLE f = CreateFileA(file, GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, 0);
+    if (f == INVALID_HANDLE_VALUE) return false;
+    return mapHandleOf(f, true);
+}
+
+inline bool MappedFile::openStdin() {
+    close();
+    HANDLE f = GetStdHandle(STD_INPUT_HANDLE);
+    if (f == INVALID_HANDLE_VALUE || f == 0) return false;
+    return mapHandleOf(f, false);
+}
+#else
+inline bool MappedFile::mapDescriptor(int f, bool owns) {
+    struct stat st;
+    if (fstat(f, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) {
+        if (owns) ::close(f);
+        return false;
+    }
+    void* p = mmap(0, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, f, 0);
+    if (p == MAP_FAILED) {
+        if (owns) ::close(f);
+        return false;
+    }
+    fd = f;
+    ownsFile = owns;
+    data = (const char*)p;
+    size = (size_t)st.st_size;
+    return true;
+}
+
+inline bool MappedFile::open(const char* file) {
+    close();
+    int f = ::open(file, O_RDONLY);
+    if (f < 0) return false;
+    return mapDescriptor(f, true);
+}
+
+inline bool MappedFile::openStdin() {
+    close();
+    return mapDescriptor(0, false);
+}
+#endif
+
+inline void MappedFile::close() {
+    if (!data) return;
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle((HANDLE)mapHandle);
+    if (ownsFile) CloseHandle((HANDLE)fileHandle);
+    fileHandle = 0;
+    mapHandle = 0;
+#else
+    munmap((void*)data, size);
+    if (ownsFile) ::close(fd);
+    fd = -1;
+#endif
+    ownsFile = false;
+    data = 0;
+    size = 0;
+}
+
+#endif
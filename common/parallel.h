@@ -0,0 +1,39 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+// 简单的并行循环（三个题目共用，仅头文件）：threads 个工作线程动态领取 [0, count) 中的下标
+// fn(i, tid) 中 tid 为线程编号（0..threads-1），可用于索引线程私有的工作区
+
+#include <vector>
+#include <thread>
+#include <atomic>
+
+// 默认线程数：硬件并发数（取不到时为 1）
+inline int defaultThreadCount() {
+    unsigned hc = std::thread::hardware_concurrency();
+    return hc == 0 ? 1 : (int)hc;
+}
+
+template <class Fn>
+void parallelFor(int count, int threads, Fn fn) {
+    if (threads < 1) threads = 1;
+    if (threads > count) threads = count;
+    if (threads <= 1) {
+        for (int i = 0; i < count; ++i) fn(i, 0);
+        return;
+    }
+    std::atomic<int> next(0);
+    std::vector<std::thread> pool;
+    for (int tid = 0; tid < threads; ++tid) {
+        pool.push_back(std::thread([&next, count, tid, &fn]() {
+            while (true) {
+                int i = next.fetch_add(1);
+                if (i >= count) break;
+                fn(i, tid);
+            }
+        }));
+    }
+    for (size_t k = 0; k < pool.size(); ++k) pool[k].join();
+}
+
+#endif
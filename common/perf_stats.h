@@ -0,0 +1,83 @@
+#ifndef PERF_STATS_H
+#define PERF_STATS_H
+
+// 热点计数器（三个题目共用，仅头文件）
+// 编译时加 -DPERF_STATS 启用：求解器中的 PERF_INC / PERF_ADD 累加到线程局部计数器；
+// 未定义时两个宏展开为空语句，热点循环中不产生任何额外指令
+// 用法：每次查询前 perfReset()，查询后 perfWriteJson() 输出一行 JSON（计数 + steady_clock 高精度耗时）
+
+#include <ostream>
+#include <chrono>
+
+enum PerfCounter {
+    PERF_SETTLED,    // 最短路：确定（出堆且有效）的节点 / 标签数
+    PERF_PUSHES,    // 最短路：入堆次数
+    PERF_STALE_POPS,    // 最短路：弹出的过期堆记录数
+    PERF_RELAXED,    // 最短路：扫描（尝试松弛）的边数
+    PERF_LINES_EXPANDED,    // 公交：最少换乘中出队展开的线路数；综合最优中在线路上出堆的状态数
+    PERF_STATES_PUSHED,    // 公交：入队 / 入堆的状态数
+    PERF_DFS_NODES,    // 停车：回溯搜索访问的节点数
+    PERF_BOUND_PRUNES,    // 停车：被当前最优或下界剪掉的节点数
+    PERF_COUNTER_COUNT
+};
+
+inline const char* perfCounterName(int c) {
+    static const char* names[PERF_COUNTER_COUNT] = {
+        "settled", "pushes", "stale_pops", "relaxed",
+        "lines_expanded", "states_pushed", "dfs_nodes", "bound_prunes"
+    };
+    return names[c];
+}
+
+// 当前线程的计数器（批量查询中每个线程各自累计）
+inline long long* perfCounters() {
+    static thread_local long long counters[PERF_COUNTER_COUNT] = { 0 };
+    return counters;
+}
+
+#ifdef PERF_STATS
+#define PERF_INC(c) (++perfCounters()[(c)])
+#define PERF_ADD(c, n) (perfCounters()[(c)] += (long long)(n))
+#else
+#define PERF_INC(c) ((void)0)
+#define PERF_ADD(c, n) ((void)0)
+#endif
+
+// 是否以 -DPERF_STATS 编译（未启用时计数恒为 0）
+inline bool perfStatsCompiled() {
+#ifdef PERF_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+
+inline void perfReset() {
+    long long* c = perfCounters();
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) c[i] = 0;
+}
+
+// 高精度计时（steady_clock），替代 clock() 的粗粒度计时用于统计输出
+struct PerfTimer {
+    std::chrono::steady_clock::time_point start;
+    PerfTimer() : start(std::chrono::steady_clock::now()) {}
+    double elapsedMs() const {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+};
+
+// 单行 JSON：{"program":..,"query":..,"solver":..,"elapsed_ms":..,"settled":..,...}
+inline void perfWriteJson(std::ostream& os, const char* program, long long query, const char* solver, double elapsedMs) {
+    std::ios::fmtflags flags = os.flags();
+    std::streamsize prec = os.precision();
+    os.setf(std::ios::fixed, std::ios::floatfield);
+    os.precision(6);
+    os << "{\"program\":\"" << program << "\",\"query\":" << query << ",\"solver\":\"" << solver << "\",\"elapsed_ms\":" << elapsedMs;
+    const long long* c = perfCounters();
+    for (int i = 0; i < PERF_COUNTER_COUNT; ++i) os << ",\"" << perfCounterName(i) << "\":" << c[i];
+    os << "}\n";
+    os.flags(flags);
+    os.precision(prec);
+}
+
+#endif